@@ -0,0 +1,527 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "BattleGrid.h"
+
+// Пакетная симуляция: K независимых партий в битбордах структуры массивов.
+// Каждая дорожка (lane) - один стрелок против случайной расстановки по правилам BattleGrid:
+// корабли не касаются друг друга, вокруг потопленного корабля клетки отмечаются промахами.
+// Все операции - циклы по дорожкам, которые компилятор векторизует.
+template <int K>
+class BatchBattle {
+public:
+    static const int LANES = K;
+
+private:
+    static const uint16_t ROW_MASK = (1u << GRID_SIZE) - 1;
+
+    // [строка][дорожка]
+    uint16_t ships[GRID_SIZE][K];
+    uint16_t blocked[GRID_SIZE][K];     // корабли и их окрестность - для проверки расстановки
+    uint16_t shots[GRID_SIZE][K];       // обстрелянные и отмеченные вокруг потопленных клетки
+    uint16_t hits[GRID_SIZE][K];
+    uint16_t sunk[GRID_SIZE][K];
+    uint16_t shipCells[FLEET_SHIP_COUNT][GRID_SIZE][K];
+    uint8_t shipAlive[FLEET_SHIP_COUNT][K];
+    uint8_t unknown[GRID_SIZE][GRID_SIZE][K];
+    uint8_t heat[GRID_SIZE][GRID_SIZE][K];
+    uint32_t rng[K];
+    int shipsLeft[K];
+    int shotsTaken[K];
+
+    uint32_t nextRandom(int lane) {
+        uint32_t x = rng[lane];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        rng[lane] = x;
+        return x;
+    }
+
+    static int bitCount(uint16_t v) {
+        v = static_cast<uint16_t>(v - ((v >> 1) & 0x5555));
+        v = static_cast<uint16_t>((v & 0x3333) + ((v >> 2) & 0x3333));
+        v = static_cast<uint16_t>((v + (v >> 4)) & 0x0F0F);
+        return (v + (v >> 8)) & 0x1F;
+    }
+
+    static int lowestBit(uint16_t v) {
+        int index = 0;
+        while (!(v & 1)) {
+            v >>= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    static uint16_t laneMask(bool value) {
+        return static_cast<uint16_t>(-static_cast<int>(value));
+    }
+
+    // Маска расстановки в строке row, 0 если корабль не задевает строку.
+    // Без ветвлений, чтобы цикл по дорожкам векторизовался.
+    static uint16_t placementRow(int row, int x, int y, int size, bool horizontal) {
+        uint16_t span = static_cast<uint16_t>(((1u << size) - 1) << x);
+        uint16_t dot = static_cast<uint16_t>(1u << x);
+        uint16_t h = laneMask(horizontal);
+        uint16_t inRow = laneMask(row == y);
+        uint16_t inColumn = laneMask(static_cast<unsigned>(row - y) < static_cast<unsigned>(size));
+        return static_cast<uint16_t>((span & inRow & h) | (dot & inColumn & static_cast<uint16_t>(~h)));
+    }
+
+    // Клетки корабля вместе с окрестностью
+    static void dilate(const uint16_t cells[GRID_SIZE][K], uint16_t out[GRID_SIZE][K]) {
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                out[row][l] = cells[row][l];
+            }
+        }
+        for (int row = 1; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                out[row][l] |= cells[row - 1][l];
+                out[row - 1][l] |= cells[row][l];
+            }
+        }
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                uint16_t v = out[row][l];
+                out[row][l] = static_cast<uint16_t>((v | (v << 1) | (v >> 1)) & ROW_MASK);
+            }
+        }
+    }
+
+public:
+    explicit BatchBattle(uint32_t seed) {
+        // splitmix32 - независимые стартовые состояния дорожек
+        for (int l = 0; l < K; ++l) {
+            uint32_t z = seed + 0x9E3779B9u * static_cast<uint32_t>(l + 1);
+            z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+            z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+            z ^= z >> 16;
+            rng[l] = z ? z : 1;
+        }
+        clear();
+    }
+
+    void clear() {
+        std::memset(ships, 0, sizeof(ships));
+        std::memset(blocked, 0, sizeof(blocked));
+        std::memset(shots, 0, sizeof(shots));
+        std::memset(hits, 0, sizeof(hits));
+        std::memset(sunk, 0, sizeof(sunk));
+        std::memset(shipCells, 0, sizeof(shipCells));
+        std::memset(shipAlive, 0, sizeof(shipAlive));
+        for (int l = 0; l < K; ++l) {
+            shipsLeft[l] = 0;
+            shotsTaken[l] = 0;
+        }
+    }
+
+    // Проверка расстановки сразу для всех дорожек: ok[l] = BattleGrid::canPlaceShip
+    void canPlaceShip(const int x[K], const int y[K], int size, const bool horizontal[K], bool ok[K]) const {
+        uint16_t conflict[K];
+        for (int l = 0; l < K; ++l) {
+            int end = horizontal[l] ? x[l] + size : y[l] + size;
+            conflict[l] = laneMask(end > GRID_SIZE);
+        }
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                conflict[l] |= placementRow(row, x[l], y[l], size, horizontal[l]) & blocked[row][l];
+            }
+        }
+        for (int l = 0; l < K; ++l) {
+            ok[l] = conflict[l] == 0;
+        }
+    }
+
+    // Ставит корабль с номером ship на дорожках, где place[l] истинно (проверка уже выполнена)
+    void placeShip(int ship, const int x[K], const int y[K], int size, const bool horizontal[K], const bool place[K]) {
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                uint16_t cells = placementRow(row, x[l], y[l], size, horizontal[l]) & laneMask(place[l]);
+                shipCells[ship][row][l] |= cells;
+                ships[row][l] |= cells;
+            }
+        }
+        uint16_t halo[GRID_SIZE][K];
+        dilate(shipCells[ship], halo);
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                blocked[row][l] |= halo[row][l];
+            }
+        }
+        for (int l = 0; l < K; ++l) {
+            shipAlive[ship][l] |= place[l] ? 1 : 0;
+            shipsLeft[l] += place[l] ? 1 : 0;
+        }
+    }
+
+    // Случайная расстановка стандартного флота на всех дорожках.
+    // Вместо перебора случайных позиций, как в placeComputerShips, сразу выбирается
+    // равновероятная позиция из допустимых - распределение то же, но без повторов.
+    void placeFleets() {
+        bool restart = true;
+        while (restart) {
+            clear();
+            restart = false;
+            for (int s = 0; s < FLEET_SHIP_COUNT && !restart; ++s) {
+                restart = !placeRandomShip(s, FLEET_SIZES[s]);
+            }
+        }
+    }
+
+    bool placeRandomShip(int ship, int size) {
+        uint16_t free[GRID_SIZE][K];
+        uint16_t hStarts[GRID_SIZE][K];
+        uint16_t vStarts[GRID_SIZE][K];
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                free[row][l] = static_cast<uint16_t>(~blocked[row][l]) & ROW_MASK;
+                hStarts[row][l] = free[row][l];
+                vStarts[row][l] = row + size <= GRID_SIZE && size > 1 ? free[row][l] : 0;
+            }
+        }
+        for (int k = 1; k < size; ++k) {
+            for (int row = 0; row < GRID_SIZE; ++row) {
+                for (int l = 0; l < K; ++l) {
+                    hStarts[row][l] &= free[row][l] >> k;
+                }
+            }
+            for (int row = 0; row + k < GRID_SIZE; ++row) {
+                for (int l = 0; l < K; ++l) {
+                    vStarts[row][l] &= free[row + k][l];
+                }
+            }
+        }
+
+        int x[K], y[K];
+        bool horizontal[K], all[K];
+        for (int l = 0; l < K; ++l) {
+            int total = 0;
+            for (int row = 0; row < GRID_SIZE; ++row) {
+                total += bitCount(hStarts[row][l]) + bitCount(vStarts[row][l]);
+            }
+            if (total == 0) return false;
+
+            int pick = static_cast<int>(((nextRandom(l) >> 16) * static_cast<uint32_t>(total)) >> 16);
+            for (int i = 0; i < 2 * GRID_SIZE; ++i) {
+                uint16_t mask = i < GRID_SIZE ? hStarts[i][l] : vStarts[i - GRID_SIZE][l];
+                int c = bitCount(mask);
+                if (pick >= c) {
+                    pick -= c;
+                    continue;
+                }
+                while (pick-- > 0) {
+                    mask &= static_cast<uint16_t>(mask - 1);
+                }
+                x[l] = lowestBit(mask);
+                y[l] = i % GRID_SIZE;
+                horizontal[l] = i < GRID_SIZE;
+                break;
+            }
+            all[l] = true;
+        }
+        placeShip(ship, x, y, size, horizontal, all);
+        return true;
+    }
+
+    // Выстрел по (x[l], y[l]) на активных дорожках, результат как у BattleGrid::attack
+    void attack(const int x[K], const int y[K], const bool active[K], CellState result[K]) {
+        // Выстрел меняет одну строку дорожки - адресуем ее напрямую, а не проходом
+        // по всем строкам (сдвиги на разные величины по дорожкам не векторизуются)
+        uint16_t wasHit[K];
+        for (int l = 0; l < K; ++l) {
+            uint16_t cell = static_cast<uint16_t>(1u << x[l]) & laneMask(active[l]);
+            uint16_t& rowShots = shots[y[l]][l];
+            uint16_t fresh = cell & static_cast<uint16_t>(~rowShots) & ships[y[l]][l];
+            rowShots |= cell;
+            hits[y[l]][l] |= fresh;
+            wasHit[l] = fresh;
+            result[l] = fresh ? CellState::Hit : CellState::Miss;
+            shotsTaken[l] += active[l] ? 1 : 0;
+        }
+
+        // Определение потопленных кораблей и отметка клеток вокруг них
+        for (int s = 0; s < FLEET_SHIP_COUNT; ++s) {
+            uint16_t remaining[K];
+            for (int l = 0; l < K; ++l) {
+                remaining[l] = 0;
+            }
+            for (int row = 0; row < GRID_SIZE; ++row) {
+                for (int l = 0; l < K; ++l) {
+                    remaining[l] |= shipCells[s][row][l] & static_cast<uint16_t>(~hits[row][l]);
+                }
+            }
+            uint16_t sinks[K];
+            uint16_t any = 0;
+            for (int l = 0; l < K; ++l) {
+                sinks[l] = laneMask(wasHit[l] != 0) & laneMask(shipAlive[s][l] != 0) & laneMask(remaining[l] == 0);
+                any |= sinks[l];
+            }
+            if (!any) continue;
+
+            uint16_t halo[GRID_SIZE][K];
+            dilate(shipCells[s], halo);
+            for (int row = 0; row < GRID_SIZE; ++row) {
+                for (int l = 0; l < K; ++l) {
+                    shots[row][l] |= halo[row][l] & sinks[l];
+                    sunk[row][l] |= shipCells[s][row][l] & sinks[l];
+                }
+            }
+            for (int l = 0; l < K; ++l) {
+                if (sinks[l]) {
+                    shipAlive[s][l] = 0;
+                    shipsLeft[l]--;
+                    result[l] = CellState::Destroyed;
+                }
+            }
+        }
+    }
+
+private:
+    // Плотность вдоль линий одного направления. Клетка i линии - W байт (по байту
+    // на дорожку или на пару столбец-дорожка) по адресу open + i * stride; open -
+    // 0xFF для необстрелянной клетки. weight[len] - W байт: сколько кораблей длины
+    // len осталось. Корабли короче minLen пропускаются.
+    // Начала расстановок длины len получаются из начал длины len - 1 одним AND, а
+    // покрытие клетки i - сумма T_d[i - d], где T_d - веса начал длиннее d.
+    template <int W>
+    static void addLineHeat(const uint8_t* open, uint8_t* heatLine, int stride,
+        const uint8_t (&weight)[MAX_SHIP_SIZE + 1][W], int minLen) {
+        uint8_t run[GRID_SIZE][W];
+        uint8_t t[MAX_SHIP_SIZE][GRID_SIZE][W];
+        for (int i = 0; i < GRID_SIZE; ++i) {
+            for (int w = 0; w < W; ++w) {
+                run[i][w] = open[i * stride + w];
+            }
+        }
+        for (int len = 1; len <= MAX_SHIP_SIZE; ++len) {
+            const int last = GRID_SIZE - len;
+            if (len > 1) {
+                for (int i = 0; i <= last; ++i) {
+                    for (int w = 0; w < W; ++w) {
+                        run[i][w] &= open[(i + len - 1) * stride + w];
+                    }
+                }
+            }
+            const uint8_t use = len >= minLen ? 0xFF : 0;
+            for (int i = 0; i < GRID_SIZE; ++i) {
+                const uint8_t inside = i <= last ? use : 0;
+                for (int w = 0; w < W; ++w) {
+                    t[len - 1][i][w] = run[i][w] & weight[len][w] & inside;
+                }
+            }
+        }
+        for (int d = MAX_SHIP_SIZE - 2; d >= 0; --d) {
+            for (int i = 0; i < GRID_SIZE; ++i) {
+                for (int w = 0; w < W; ++w) {
+                    t[d][i][w] += t[d + 1][i][w];
+                }
+            }
+        }
+        for (int d = 0; d < MAX_SHIP_SIZE; ++d) {
+            for (int i = d; i < GRID_SIZE; ++i) {
+                for (int w = 0; w < W; ++w) {
+                    heatLine[i * stride + w] += t[d][i - d][w];
+                }
+            }
+        }
+    }
+
+public:
+    // Карты плотности оставшихся кораблей для всех дорожек (без весов).
+    // Клетки хранятся байтами [строка][столбец][дорожка], чтобы в регистр попадало 32 дорожки.
+    // Горизонтальные линии - строки (W = K), вертикальные - все столбцы строки сразу (W = GRID_SIZE * K).
+    void computeHeatmaps() {
+        std::memset(heat, 0, sizeof(heat));
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                for (int l = 0; l < K; ++l) {
+                    unknown[row][x][l] = static_cast<uint8_t>((((shots[row][l] >> x) & 1) ^ 1) * 0xFF);
+                }
+            }
+        }
+        uint8_t counts[MAX_SHIP_SIZE + 1][K];
+        std::memset(counts, 0, sizeof(counts));
+        for (int s = 0; s < FLEET_SHIP_COUNT; ++s) {
+            for (int l = 0; l < K; ++l) {
+                counts[FLEET_SIZES[s]][l] += shipAlive[s][l];
+            }
+        }
+        uint8_t rowCounts[MAX_SHIP_SIZE + 1][GRID_SIZE * K];
+        for (int len = 0; len <= MAX_SHIP_SIZE; ++len) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                std::memcpy(&rowCounts[len][x * K], counts[len], K);
+            }
+        }
+
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            addLineHeat<K>(&unknown[row][0][0], &heat[row][0][0], K, counts, 1);
+        }
+        // Однопалубные корабли учитываются один раз
+        addLineHeat<GRID_SIZE * K>(&unknown[0][0][0], &heat[0][0][0], GRID_SIZE * K, rowCounts, 2);
+    }
+
+    uint8_t heatAt(int lane, int x, int y) const {
+        return heat[y][x][lane];
+    }
+
+    // Выбор цели на всех дорожках: добивание раненого корабля, иначе максимум карты плотности
+    void chooseTargets(int x[K], int y[K]) {
+        computeHeatmaps();
+
+        // Раненые, но не потопленные клетки; строки 0 и GRID_SIZE + 1 - пустая рамка
+        uint16_t wounded[GRID_SIZE + 2][K];
+        uint16_t anyWounded[K], lineH[K], lineV[K], salt[K];
+        for (int l = 0; l < K; ++l) {
+            wounded[0][l] = 0;
+            wounded[GRID_SIZE + 1][l] = 0;
+            anyWounded[l] = 0;
+            lineH[l] = 0;
+            lineV[l] = 0;
+            salt[l] = static_cast<uint16_t>(nextRandom(l) >> 16);
+        }
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                wounded[row + 1][l] = hits[row][l] & static_cast<uint16_t>(~sunk[row][l]);
+            }
+        }
+        for (int row = 1; row <= GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                uint16_t w = wounded[row][l];
+                anyWounded[l] |= w;
+                lineH[l] |= w & (w >> 1);
+                lineV[l] |= w & wounded[row + 1][l];
+            }
+        }
+
+        // Ориентация раненого корабля известна - добиваем только вдоль нее
+        uint16_t eligible[GRID_SIZE][K];
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int l = 0; l < K; ++l) {
+                uint16_t isWounded = static_cast<uint16_t>(-(anyWounded[l] != 0));
+                uint16_t isH = static_cast<uint16_t>(-(lineH[l] != 0));
+                uint16_t isV = static_cast<uint16_t>(-(lineV[l] != 0));
+                uint16_t w = wounded[row + 1][l];
+                uint16_t nearH = static_cast<uint16_t>((w << 1) | (w >> 1));
+                uint16_t nearV = wounded[row][l] | wounded[row + 2][l];
+                uint16_t near = (nearH & static_cast<uint16_t>(~(isV & ~isH))) | (nearV & static_cast<uint16_t>(~isH));
+                uint16_t open = static_cast<uint16_t>(~shots[row][l]) & ROW_MASK;
+                eligible[row][l] = ((near & isWounded) | static_cast<uint16_t>(~isWounded)) & open;
+            }
+        }
+
+        // Счет клетки: плотность в старших битах, случайная добавка для равных клеток в младших
+        uint16_t best[K], bestX[K], bestY[K];
+        for (int l = 0; l < K; ++l) {
+            best[l] = 0;
+            bestX[l] = 0;
+            bestY[l] = 0;
+        }
+        for (int row = 0; row < GRID_SIZE; ++row) {
+            for (int col = 0; col < GRID_SIZE; ++col) {
+                const uint16_t cellHash = static_cast<uint16_t>((row * GRID_SIZE + col) * 0x9E37 + 0x79B9);
+                for (int l = 0; l < K; ++l) {
+                    uint16_t jitter = static_cast<uint16_t>(static_cast<uint16_t>((salt[l] ^ cellHash) * 0x6F4B) >> 10);
+                    uint16_t allowed = static_cast<uint16_t>(-((eligible[row][l] >> col) & 1));
+                    uint16_t score = static_cast<uint16_t>((heat[row][col][l] + 1) << 6 | jitter) & allowed;
+                    uint16_t better = static_cast<uint16_t>(-(score > best[l]));
+                    best[l] = (score & better) | (best[l] & static_cast<uint16_t>(~better));
+                    bestX[l] = (static_cast<uint16_t>(col) & better) | (bestX[l] & static_cast<uint16_t>(~better));
+                    bestY[l] = (static_cast<uint16_t>(row) & better) | (bestY[l] & static_cast<uint16_t>(~better));
+                }
+            }
+        }
+        for (int l = 0; l < K; ++l) {
+            x[l] = bestX[l];
+            y[l] = bestY[l];
+        }
+
+        // Если рядом с ранеными кораблями нет свободных клеток - любая необстрелянная
+        for (int l = 0; l < K; ++l) {
+            if (best[l] != 0 || shipsLeft[l] == 0) continue;
+            for (int i = 0; i < GRID_SIZE * GRID_SIZE && best[l] == 0; ++i) {
+                if (!(shots[i / GRID_SIZE][l] >> (i % GRID_SIZE) & 1)) {
+                    best[l] = 1;
+                    x[l] = i % GRID_SIZE;
+                    y[l] = i / GRID_SIZE;
+                }
+            }
+        }
+    }
+
+    // Каждая незавершенная партия делает один выстрел; выстрелы и результаты
+    // возвращаются для проверки по BattleGrid (active[l] - дорожка стреляла)
+    void step(int x[K], int y[K], bool active[K], CellState result[K]) {
+        chooseTargets(x, y);
+        for (int l = 0; l < K; ++l) {
+            active[l] = shipsLeft[l] > 0;
+        }
+        attack(x, y, active, result);
+    }
+
+    void step() {
+        int x[K], y[K];
+        bool active[K];
+        CellState result[K];
+        step(x, y, active, result);
+    }
+
+    // Расстановка дорожки lane на пустом поле BattleGrid в том же порядке кораблей.
+    // false - корабль не удалось поставить по правилам BattleGrid.
+    bool exportFleet(int lane, BattleGrid& grid) const {
+        for (int s = 0; s < FLEET_SHIP_COUNT; ++s) {
+            int row = 0;
+            while (row < GRID_SIZE && shipCells[s][row][lane] == 0) ++row;
+            if (row == GRID_SIZE) return false;
+            uint16_t cells = shipCells[s][row][lane];
+            bool horizontal = bitCount(cells) > 1 || FLEET_SIZES[s] == 1;
+            if (!grid.placeShip(lowestBit(cells), row, FLEET_SIZES[s], horizontal)) return false;
+        }
+        return true;
+    }
+
+    bool finished(int lane) const {
+        return shipsLeft[lane] == 0;
+    }
+
+    bool allFinished() const {
+        for (int l = 0; l < K; ++l) {
+            if (shipsLeft[l] > 0) return false;
+        }
+        return true;
+    }
+
+    int shotsToWin(int lane) const {
+        return shotsTaken[lane];
+    }
+
+    // Состояние клетки в тех же обозначениях, что и BattleGrid::getGrid
+    CellState cellState(int lane, int x, int y) const {
+        uint16_t bit = static_cast<uint16_t>(1u << x);
+        if (sunk[y][lane] & bit) return CellState::Destroyed;
+        if (hits[y][lane] & bit) return CellState::Hit;
+        if (shots[y][lane] & bit) return CellState::Miss;
+        if (ships[y][lane] & bit) return CellState::Ship;
+        return CellState::Empty;
+    }
+};
+
+// Играет games партий пакетами по K, результат - число выстрелов до победы в каждой партии
+template <int K>
+void runBatchGames(int games, uint32_t seed, std::vector<int>& shotsToWin) {
+    std::unique_ptr<BatchBattle<K>> battle(new BatchBattle<K>(seed));
+    BatchBattle<K>& b = *battle;
+    for (int played = 0; played < games; played += K) {
+        b.placeFleets();
+        while (!b.allFinished()) {
+            b.step();
+        }
+        for (int l = 0; l < K && played + l < games; ++l) {
+            shotsToWin.push_back(b.shotsToWin(l));
+        }
+    }
+}
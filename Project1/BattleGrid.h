@@ -0,0 +1,202 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+const int GRID_SIZE = 10;
+const int MAX_SHIP_SIZE = 4;
+const int FLEET_SHIP_COUNT = 10;
+const int FLEET_SIZES[FLEET_SHIP_COUNT] = { 4, 3, 3, 2, 2, 2, 1, 1, 1, 1 };
+
+enum class CellState {
+    Empty,
+    Ship,
+    Hit,
+    Miss,
+    Destroyed
+};
+
+class Ship {
+public:
+    int size;
+    bool horizontal;
+    std::vector<std::pair<int, int>> positions;
+    std::vector<bool> hits;
+
+    Ship(int s, bool h, int x, int y) : size(s), horizontal(h) {
+        for (int i = 0; i < size; ++i) {
+            if (horizontal) {
+                positions.emplace_back(x + i, y);
+            }
+            else {
+                positions.emplace_back(x, y + i);
+            }
+            hits.push_back(false);
+        }
+    }
+
+    bool isDestroyed() const {
+        for (bool hit : hits) {
+            if (!hit) return false;
+        }
+        return true;
+    }
+};
+
+// По биту на клетку поля: какие клетки изменились
+struct DirtyMask {
+    static const int WORDS = (GRID_SIZE * GRID_SIZE + 63) / 64;
+
+    uint64_t bits[WORDS] = {};
+
+    void set(int x, int y) {
+        int index = y * GRID_SIZE + x;
+        bits[index / 64] |= 1ull << (index % 64);
+    }
+
+    void setAll() {
+        for (int w = 0; w < WORDS; ++w) bits[w] = ~0ull;
+    }
+
+    void merge(const DirtyMask& other) {
+        for (int w = 0; w < WORDS; ++w) bits[w] |= other.bits[w];
+    }
+
+    // Вызывает onCell(x, y) для отмеченных клеток; пустая маска стоит O(GRID_SIZE^2 / 64)
+    template <class F>
+    void forEach(F onCell) const {
+        for (int w = 0; w < WORDS; ++w) {
+            uint64_t word = bits[w];
+            for (int b = 0; word != 0; ++b, word >>= 1) {
+                int index = w * 64 + b;
+                if ((word & 1) && index < GRID_SIZE * GRID_SIZE) {
+                    onCell(index % GRID_SIZE, index / GRID_SIZE);
+                }
+            }
+        }
+    }
+};
+
+class BattleGrid {
+private:
+    std::vector<std::vector<CellState>> grid;
+    std::vector<Ship> ships;
+    DirtyMask dirty;                // клетки, изменившиеся с прошлого consumeDirty
+
+    void setCell(int x, int y, CellState state) {
+        grid[y][x] = state;
+        dirty.set(x, y);
+    }
+
+public:
+    BattleGrid() {
+        grid.resize(GRID_SIZE, std::vector<CellState>(GRID_SIZE, CellState::Empty));
+        dirty.setAll();
+    }
+
+    void clear() {
+        for (auto& row : grid) {
+            for (auto& cell : row) {
+                cell = CellState::Empty;
+            }
+        }
+        ships.clear();
+        dirty.setAll();
+    }
+
+    // Добавляет в out клетки, изменившиеся с прошлого вызова, и сбрасывает отметки
+    void consumeDirty(DirtyMask& out) {
+        out.merge(dirty);
+        dirty = DirtyMask();
+    }
+
+    bool canPlaceShip(int x, int y, int size, bool horizontal) const {
+        if (horizontal) {
+            if (x + size > GRID_SIZE) return false;
+            for (int i = x - 1; i <= x + size; ++i) {
+                for (int j = y - 1; j <= y + 1; ++j) {
+                    if (i >= 0 && i < GRID_SIZE && j >= 0 && j < GRID_SIZE) {
+                        if (grid[j][i] != CellState::Empty) return false;
+                    }
+                }
+            }
+        }
+        else {
+            if (y + size > GRID_SIZE) return false;
+            for (int i = x - 1; i <= x + 1; ++i) {
+                for (int j = y - 1; j <= y + size; ++j) {
+                    if (i >= 0 && i < GRID_SIZE && j >= 0 && j < GRID_SIZE) {
+                        if (grid[j][i] != CellState::Empty) return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    bool placeShip(int x, int y, int size, bool horizontal) {
+        if (!canPlaceShip(x, y, size, horizontal)) return false;
+
+        Ship ship(size, horizontal, x, y);
+        ships.push_back(ship);
+
+        for (const auto& pos : ship.positions) {
+            setCell(pos.first, pos.second, CellState::Ship);
+        }
+        return true;
+    }
+
+    CellState attack(int x, int y) {
+        if (grid[y][x] == CellState::Ship) {
+            setCell(x, y, CellState::Hit);
+
+            for (auto& ship : ships) {
+                for (int i = 0; i < ship.positions.size(); ++i) {
+                    if (ship.positions[i].first == x && ship.positions[i].second == y) {
+                        ship.hits[i] = true;
+                        if (ship.isDestroyed()) {
+                            markAroundDestroyedShip(ship);
+                            return CellState::Destroyed;
+                        }
+                        return CellState::Hit;
+                    }
+                }
+            }
+        }
+        else if (grid[y][x] == CellState::Empty) {
+            setCell(x, y, CellState::Miss);
+            return CellState::Miss;
+        }
+        return grid[y][x];
+    }
+
+    void markAroundDestroyedShip(const Ship& ship) {
+        for (const auto& pos : ship.positions) {
+            for (int x = pos.first - 1; x <= pos.first + 1; ++x) {
+                for (int y = pos.second - 1; y <= pos.second + 1; ++y) {
+                    if (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE) {
+                        if (grid[y][x] == CellState::Empty) {
+                            setCell(x, y, CellState::Miss);
+                        }
+                    }
+                }
+            }
+            setCell(pos.first, pos.second, CellState::Destroyed);
+        }
+    }
+
+    bool allShipsDestroyed() const {
+        for (const auto& ship : ships) {
+            if (!ship.isDestroyed()) return false;
+        }
+        return true;
+    }
+
+    const std::vector<std::vector<CellState>>& getGrid() const {
+        return grid;
+    }
+
+    const std::vector<Ship>& getShips() const {
+        return ships;
+    }
+};
@@ -0,0 +1,83 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+#include "BattleGrid.h"
+#include "GlyphAtlas.h"
+#include "DrawStats.h"
+
+// Геометрия одного поля: по одному четырехугольнику на клетку с картинкой из
+// атласа, поле рисуется одним вызовом draw. Вершины переписываются только для
+// клеток, отмеченных в маске изменений поля. Линии сетки не меняются и рисуются
+// отдельно (drawGridLines), в статичный слой.
+class BoardMesh {
+private:
+    static const int QUAD_VERTICES = 6;
+
+    const GlyphAtlas* atlas;
+    float cellSize;
+    bool showShips;
+    CellState shown[GRID_SIZE][GRID_SIZE];
+    sf::VertexArray cells;
+    sf::VertexArray gridLines;
+
+    void buildGridLines() {
+        const float length = GRID_SIZE * cellSize;
+        for (int i = 0; i <= GRID_SIZE; ++i) {
+            sf::Vertex* v = &gridLines[i * 4];
+            v[0].position = sf::Vector2f(i * cellSize, 0);
+            v[1].position = sf::Vector2f(i * cellSize, length);
+            v[2].position = sf::Vector2f(0, i * cellSize);
+            v[3].position = sf::Vector2f(length, i * cellSize);
+            for (int k = 0; k < 4; ++k) v[k].color = sf::Color::Black;
+        }
+    }
+
+public:
+    BoardMesh(const GlyphAtlas& glyphs, bool ships) : atlas(&glyphs), cellSize(static_cast<float>(glyphs.getCellSize())),
+        showShips(ships), cells(sf::Triangles, GRID_SIZE * GRID_SIZE * QUAD_VERTICES), gridLines(sf::Lines, (GRID_SIZE + 1) * 4) {
+        buildGridLines();
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                writeCell(x, y, CellState::Empty);
+            }
+        }
+    }
+
+    // Переписывает вершины одной клетки
+    void writeCell(int x, int y, CellState state) {
+        shown[y][x] = state;
+        sf::FloatRect target(x * cellSize, y * cellSize, cellSize, cellSize);
+        atlas->writeQuad(&cells[(y * GRID_SIZE + x) * QUAD_VERTICES], cellGlyph(state, showShips), target);
+    }
+
+    // Переписывает все клетки (картинки в атласе сменили координаты)
+    void rebuild() {
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                writeCell(x, y, shown[y][x]);
+            }
+        }
+    }
+
+    // Переписывает только отмеченные клетки; остальные значения current не читаются
+    void update(const CellState (&current)[GRID_SIZE][GRID_SIZE], const DirtyMask& dirty) {
+        dirty.forEach([&](int x, int y) {
+            writeCell(x, y, current[y][x]);
+        });
+    }
+
+    void draw(sf::RenderTarget& target, const sf::Texture& texture, float offsetX, float offsetY, DrawStats& stats) const {
+        sf::RenderStates states(&texture);
+        states.transform.translate(offsetX, offsetY);
+        target.draw(cells, states);
+        stats.add(cells.getVertexCount());
+    }
+
+    void drawGridLines(sf::RenderTarget& target, float offsetX, float offsetY, DrawStats& stats) const {
+        sf::RenderStates states;
+        states.transform.translate(offsetX, offsetY);
+        target.draw(gridLines, states);
+        stats.add(gridLines.getVertexCount());
+    }
+};
@@ -0,0 +1,468 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+#include "BattleGrid.h"
+#include "Heatmap.h"
+#include "PlacementPrior.h"
+#include "Rng.h"
+#include "FleetSampler.h"
+
+enum class Difficulty {
+    Easy,
+    Medium,
+    Hard
+};
+
+inline const char* difficultyName(Difficulty difficulty) {
+    switch (difficulty) {
+    case Difficulty::Easy: return "easy";
+    case Difficulty::Medium: return "medium";
+    case Difficulty::Hard: return "hard";
+    }
+    return "?";
+}
+
+// Настраиваемые параметры ИИ. Значения по умолчанию дают сложному уровню поиск
+// по карте плотности без поправок (четность и край - множитель 1) и добивание
+// случайной соседней клеткой. Это не исходное поведение: раньше сложный уровень
+// в поиске стрелял в случайные клетки.
+struct AiParams {
+    float priorPlacementWeight = 4.0f;  // вес статистики расстановок игрока
+    float priorCellWeight = 1.0f;       // вес статистики занятых клеток
+    float parityBonus = 1.0f;           // множитель для клеток шахматной решетки по длине наименьшего корабля
+    float edgeWeight = 1.0f;            // множитель для клеток у края поля
+    float targetHeatWeight = 0.0f;      // при добивании: 0 - случайная цель, больше - предпочтение плотности
+    // Сложный уровень с выборкой расстановок флота (включен, если задан любой бюджет)
+    float sampleBudget = 0.0f;          // расстановок на ход, 0 - без ограничения
+    float timeBudgetMs = 0.0f;          // миллисекунд на ход, 0 - без ограничения
+
+    bool loadFromFile(const std::string& fileName);
+    bool saveToFile(const std::string& fileName) const;
+};
+
+struct AiParamField {
+    const char* name;
+    float AiParams::* field;
+};
+
+inline const std::vector<AiParamField>& aiParamFields() {
+    static const std::vector<AiParamField> fields = {
+        { "priorPlacementWeight", &AiParams::priorPlacementWeight },
+        { "priorCellWeight", &AiParams::priorCellWeight },
+        { "parityBonus", &AiParams::parityBonus },
+        { "edgeWeight", &AiParams::edgeWeight },
+        { "targetHeatWeight", &AiParams::targetHeatWeight },
+        { "sampleBudget", &AiParams::sampleBudget },
+        { "timeBudgetMs", &AiParams::timeBudgetMs }
+    };
+    return fields;
+}
+
+// Формат файла: строки "имя=значение", строки с # - комментарии
+inline bool AiParams::loadFromFile(const std::string& fileName) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    AiParams loaded = *this;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) return false;
+
+        std::string name = line.substr(0, eq);
+        std::istringstream value(line.substr(eq + 1));
+        bool known = false;
+        for (const auto& f : aiParamFields()) {
+            if (name == f.name) {
+                if (!(value >> (loaded.*f.field))) return false;
+                known = true;
+            }
+        }
+        if (!known) return false;
+    }
+    *this = loaded;
+    return true;
+}
+
+inline bool AiParams::saveToFile(const std::string& fileName) const {
+    std::ofstream out(fileName);
+    if (!out) return false;
+    out << "# Sea Battle AI parameters\n";
+    for (const auto& f : aiParamFields()) {
+        out << f.name << "=" << this->*f.field << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// Случайная расстановка стандартного флота
+inline void placeRandomFleet(BattleGrid& grid, GameRng& gen) {
+    for (int size : FLEET_SIZES) {
+        bool placed = false;
+        while (!placed) {
+            int x = randomInt(gen, 0, GRID_SIZE - 1);
+            int y = randomInt(gen, 0, GRID_SIZE - 1);
+            bool horizontal = randomInt(gen, 0, 1) == 0;
+            placed = grid.placeShip(x, y, size, horizontal);
+        }
+    }
+}
+
+class ComputerPlayer {
+private:
+    Difficulty difficulty;
+    AiParams params;
+    PlacementPrior* prior;
+    PlacementWeights densityWeights;
+    bool densityWeightsReady;
+
+    // Улучшенный ИИ бота
+    std::pair<int, int> lastHitPos;
+    bool hasLastHit;
+    std::vector<std::pair<int, int>> possibleTargets;
+    std::vector<std::pair<int, int>> directions = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    bool isHorizontalPossible;
+    bool isVerticalPossible;
+
+    static bool isOpen(const BattleGrid& grid, int x, int y) {
+        CellState cell = grid.getGrid()[y][x];
+        return cell == CellState::Empty || cell == CellState::Ship;
+    }
+
+    void addPossibleTargets(const BattleGrid& grid, int x, int y) {
+        for (const auto& dir : directions) {
+            int nx = x + dir.first;
+            int ny = y + dir.second;
+            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE) {
+                if (isOpen(grid, nx, ny)) {
+                    possibleTargets.emplace_back(nx, ny);
+                }
+            }
+        }
+    }
+
+    void updateDirectionInfo(const BattleGrid& grid, int x, int y) {
+        const auto& cells = grid.getGrid();
+
+        // Проверяем попадания по горизонтали
+        bool leftHit = (x > 0 && cells[y][x - 1] == CellState::Hit);
+        bool rightHit = (x < GRID_SIZE - 1 && cells[y][x + 1] == CellState::Hit);
+
+        // Проверяем попадания по вертикали
+        bool topHit = (y > 0 && cells[y - 1][x] == CellState::Hit);
+        bool bottomHit = (y < GRID_SIZE - 1 && cells[y + 1][x] == CellState::Hit);
+
+        // Если есть попадания по горизонтали, но нет по вертикали - корабль горизонтальный
+        if ((leftHit || rightHit) && !topHit && !bottomHit) {
+            isHorizontalPossible = true;
+            isVerticalPossible = false;
+        }
+        // Если есть попадания по вертикали, но нет по горизонтали - корабль вертикальный
+        else if (!leftHit && !rightHit && (topHit || bottomHit)) {
+            isHorizontalPossible = false;
+            isVerticalPossible = true;
+        }
+    }
+
+    void computeDensity(const BattleGrid& grid, uint16_t rows[GRID_SIZE], Heatmap& heatmap) {
+        if (!densityWeightsReady) {
+            if (prior) {
+                prior->fillWeights(densityWeights, params.priorPlacementWeight);
+            }
+            else {
+                densityWeights.fill(PRIOR_WEIGHT_SCALE);
+            }
+            densityWeightsReady = true;
+        }
+
+        int shipCounts[MAX_SHIP_SIZE + 1];
+        buildUnknownRows(grid, rows);
+        countRemainingShips(grid, shipCounts);
+        computeHeatmap(rows, shipCounts, densityWeights, heatmap);
+    }
+
+    // Выбор клетки по карте плотности возможных расстановок оставшихся кораблей
+    std::pair<int, int> findDensityTarget(const BattleGrid& grid, GameRng& gen) {
+        uint16_t rows[GRID_SIZE];
+        Heatmap heatmap;
+        computeDensity(grid, rows, heatmap);
+
+        int smallest = MAX_SHIP_SIZE;
+        for (const auto& ship : grid.getShips()) {
+            if (!ship.isDestroyed()) smallest = std::min(smallest, ship.size);
+        }
+
+        // Среди клеток с максимальной плотностью выбираем случайную
+        std::vector<std::pair<int, int>> best;
+        float bestDensity = -1.0f;
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                if (!(rows[y] >> x & 1)) continue;
+                float d = static_cast<float>(heatmap.cells[y][x]);
+                if (prior) {
+                    d *= 1.0f + params.priorCellWeight * prior->cellFrequency(x, y);
+                }
+                if ((x + y) % smallest == 0) {
+                    d *= params.parityBonus;
+                }
+                if (x == 0 || y == 0 || x == GRID_SIZE - 1 || y == GRID_SIZE - 1) {
+                    d *= params.edgeWeight;
+                }
+
+                if (d > bestDensity + 1e-4f) {
+                    bestDensity = d;
+                    best.clear();
+                }
+                if (d >= bestDensity - 1e-4f) {
+                    best.emplace_back(x, y);
+                }
+            }
+        }
+        return best[randomInt(gen, 0, static_cast<int>(best.size()) - 1)];
+    }
+
+    // Ход с ограниченным бюджетом: чем больше согласованных расстановок флота
+    // успеем перебрать, тем точнее частота занятости клеток. Если не успели ни одной,
+    // используем карту плотности.
+    std::pair<int, int> findSampledTarget(const BattleGrid& grid, GameRng& gen) {
+        BoardView view = BoardView::fromGrid(grid);
+        int maxSamples = params.sampleBudget > 0.0f ? static_cast<int>(params.sampleBudget) : INT_MAX;
+        long long maxAttempts = 4LL * maxSamples + 64;
+        auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(params.timeBudgetMs));
+
+        int counts[GRID_SIZE][GRID_SIZE] = {};
+        int samples = 0;
+        for (long long attempt = 0; samples < maxSamples && attempt < maxAttempts; ++attempt) {
+            if (params.timeBudgetMs > 0.0f && std::chrono::steady_clock::now() >= deadline) break;
+
+            uint16_t shipRows[GRID_SIZE];
+            if (!sampleFleet(view, gen, shipRows)) continue;
+            samples++;
+            for (int y = 0; y < GRID_SIZE; ++y) {
+                for (int x = 0; x < GRID_SIZE; ++x) {
+                    counts[y][x] += shipRows[y] >> x & 1;
+                }
+            }
+        }
+
+        if (samples == 0) {
+            return findDensityTarget(grid, gen);
+        }
+
+        std::vector<std::pair<int, int>> best;
+        int bestCount = -1;
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                if (!(view.unknown[y] >> x & 1)) continue;
+                if (counts[y][x] > bestCount) {
+                    bestCount = counts[y][x];
+                    best.clear();
+                }
+                if (counts[y][x] == bestCount) {
+                    best.emplace_back(x, y);
+                }
+            }
+        }
+        return best[randomInt(gen, 0, static_cast<int>(best.size()) - 1)];
+    }
+
+    // Выбор цели при добивании: случайно или с учетом плотности
+    std::pair<int, int> pickTarget(const std::vector<std::pair<int, int>>& targets, const BattleGrid& grid, GameRng& gen) {
+        if (params.targetHeatWeight <= 0.0f) {
+            return targets[randomInt(gen, 0, static_cast<int>(targets.size()) - 1)];
+        }
+
+        uint16_t rows[GRID_SIZE];
+        Heatmap heatmap;
+        computeDensity(grid, rows, heatmap);
+
+        float maxHeat = 1.0f;
+        for (const auto& t : targets) {
+            maxHeat = std::max(maxHeat, static_cast<float>(heatmap.cells[t.second][t.first]));
+        }
+        std::pair<int, int> best = targets.front();
+        float bestScore = -1.0f;
+        for (const auto& t : targets) {
+            float score = params.targetHeatWeight * heatmap.cells[t.second][t.first] / maxHeat + randomUnit(gen);
+            if (score > bestScore) {
+                bestScore = score;
+                best = t;
+            }
+        }
+        return best;
+    }
+
+public:
+    ComputerPlayer() : difficulty(Difficulty::Medium), prior(nullptr), densityWeightsReady(false),
+        hasLastHit(false), isHorizontalPossible(true), isVerticalPossible(true) {
+    }
+
+    void setDifficulty(Difficulty d) {
+        difficulty = d;
+    }
+
+    Difficulty getDifficulty() const {
+        return difficulty;
+    }
+
+    void setParams(const AiParams& p) {
+        params = p;
+        densityWeightsReady = false;
+    }
+
+    const AiParams& getParams() const {
+        return params;
+    }
+
+    // Статистика расстановок игрока, nullptr - без нее
+    void setPrior(PlacementPrior* p) {
+        prior = p;
+        densityWeightsReady = false;
+    }
+
+    // Начало новой партии
+    void reset() {
+        possibleTargets.clear();
+        hasLastHit = false;
+        isHorizontalPossible = true;
+        isVerticalPossible = true;
+        densityWeightsReady = false;
+    }
+
+    // Включен ли ход с бюджетом (выборка расстановок)
+    bool isAnytime() const {
+        return difficulty == Difficulty::Hard && (params.sampleBudget > 0.0f || params.timeBudgetMs > 0.0f);
+    }
+
+    std::pair<int, int> chooseTarget(const BattleGrid& grid, GameRng& gen) {
+        if (isAnytime()) {
+            return findSampledTarget(grid, gen);
+        }
+
+        while (true) {
+            if (difficulty == Difficulty::Easy) {
+                // Легкий уровень - случайные атаки
+                int x = randomInt(gen, 0, GRID_SIZE - 1);
+                int y = randomInt(gen, 0, GRID_SIZE - 1);
+
+                if (isOpen(grid, x, y)) {
+                    return { x, y };
+                }
+            }
+            else if (difficulty == Difficulty::Medium) {
+                // Средний уровень - добивает корабль до конца
+                if (hasLastHit && !possibleTargets.empty()) {
+                    // Атакуем первую доступную цель из списка возможных
+                    std::pair<int, int> target;
+                    bool found = false;
+                    for (auto& pos : possibleTargets) {
+                        if (isOpen(grid, pos.first, pos.second)) {
+                            target = pos;
+                            found = true;
+                            break;
+                        }
+                    }
+
+                    // Удаляем все невозможные цели
+                    possibleTargets.erase(
+                        std::remove_if(possibleTargets.begin(), possibleTargets.end(),
+                            [&grid](const std::pair<int, int>& pos) {
+                                return !isOpen(grid, pos.first, pos.second);
+                            }),
+                        possibleTargets.end()
+                    );
+
+                    if (found) {
+                        return target;
+                    }
+                }
+                else {
+                    // Случайная атака, если нет возможных целей
+                    int x = randomInt(gen, 0, GRID_SIZE - 1);
+                    int y = randomInt(gen, 0, GRID_SIZE - 1);
+
+                    if (isOpen(grid, x, y)) {
+                        return { x, y };
+                    }
+                }
+            }
+            else {
+                // Сложный уровень использует интеллектуальный алгоритм
+                if (hasLastHit && !possibleTargets.empty()) {
+                    // Если есть последнее попадание и возможные цели, атакуем их
+                    std::pair<int, int> target;
+                    bool found = false;
+
+                    // На сложном уровне определяем ориентацию корабля
+                    updateDirectionInfo(grid, lastHitPos.first, lastHitPos.second);
+
+                    // Фильтруем возможные цели по определенной ориентации
+                    std::vector<std::pair<int, int>> filteredTargets;
+                    for (const auto& pos : possibleTargets) {
+                        if ((isHorizontalPossible && pos.second == lastHitPos.second) ||
+                            (!isHorizontalPossible && pos.first == lastHitPos.first)) {
+                            filteredTargets.push_back(pos);
+                        }
+                    }
+
+                    if (!filteredTargets.empty()) {
+                        // Выбираем из отфильтрованных целей
+                        target = pickTarget(filteredTargets, grid, gen);
+                        found = true;
+
+                        // Удаляем выбранную цель из основного списка
+                        possibleTargets.erase(
+                            std::remove(possibleTargets.begin(), possibleTargets.end(), target),
+                            possibleTargets.end()
+                        );
+                    }
+
+                    if (!found) {
+                        // Если ориентация не определена или нет подходящих целей, выбираем случайную из возможных
+                        int last = static_cast<int>(possibleTargets.size()) - 1;
+                        target = possibleTargets[randomInt(gen, 0, last)];
+                        possibleTargets.erase(possibleTargets.begin() + randomInt(gen, 0, last));
+                    }
+
+                    if (isOpen(grid, target.first, target.second)) {
+                        return target;
+                    }
+                }
+                else {
+                    // Поиск по карте плотности с учетом привычек игрока
+                    return findDensityTarget(grid, gen);
+                }
+            }
+        }
+    }
+
+    // Учет результата выстрела по (x, y)
+    void onAttackResult(const BattleGrid& grid, int x, int y, CellState result) {
+        if (result == CellState::Hit || result == CellState::Destroyed) {
+            lastHitPos = { x, y };
+            hasLastHit = true;
+            if (difficulty == Difficulty::Hard) {
+                updateDirectionInfo(grid, x, y);
+                addPossibleTargets(grid, x, y);
+            }
+            else if (difficulty == Difficulty::Medium) {
+                addPossibleTargets(grid, x, y);
+            }
+        }
+
+        if (result == CellState::Destroyed) {
+            possibleTargets.clear();
+            hasLastHit = false;
+            isHorizontalPossible = true;
+            isVerticalPossible = true;
+        }
+    }
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+// Вызовы draw и вершины за кадр. SFML их не считает, поэтому считает код
+// рисования; для текста и фигур - по тому, как SFML строит их геометрию.
+struct DrawStats {
+    int drawCalls = 0;
+    size_t vertices = 0;
+
+    void reset() {
+        drawCalls = 0;
+        vertices = 0;
+    }
+
+    void add(size_t vertexCount, int calls = 1) {
+        drawCalls += calls;
+        vertices += vertexCount;
+    }
+
+    // Текст - один draw, по два треугольника на символ
+    void addText(const sf::Text& text) {
+        add(text.getString().getSize() * 6);
+    }
+
+    // Фигура - заливка веером и, если задана, обводка полосой
+    void addShape(const sf::Shape& shape) {
+        add(shape.getPointCount() + 2);
+        if (shape.getOutlineThickness() != 0) {
+            add((shape.getPointCount() + 1) * 2);
+        }
+    }
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <algorithm>
+
+#include "GlyphAtlas.h"
+
+// Кривые сглаживания, t от 0 до 1
+enum class Ease {
+    Linear,
+    InQuad,
+    OutQuad,
+    OutCubic
+};
+
+inline float applyEase(Ease ease, float t) {
+    switch (ease) {
+    case Ease::InQuad:
+        return t * t;
+    case Ease::OutQuad:
+        return 1.0f - (1.0f - t) * (1.0f - t);
+    case Ease::OutCubic:
+        return 1.0f - (1.0f - t) * (1.0f - t) * (1.0f - t);
+    default:
+        return t;
+    }
+}
+
+// Эффект - картинка атласа с центром center. Размер и цвет за duration секунд
+// переходят от начальных к конечным по своим кривым; delay - задержка перед стартом.
+struct Effect {
+    Glyph glyph = Glyph::Explosion;
+    sf::Vector2f center;
+    float delay = 0.0f;
+    float duration = 1.0f;
+    float sizeFrom = 0.0f;
+    float sizeTo = 0.0f;
+    sf::Color colorFrom = sf::Color::White;
+    sf::Color colorTo = sf::Color::Transparent;
+    Ease sizeEase = Ease::Linear;
+    Ease colorEase = Ease::Linear;
+    float age = 0.0f;
+};
+
+// Эффекты (волны, взрывы, затухания) в массиве фиксированного размера: без
+// выделения памяти во время игры. Время идет по приращению dt, поэтому эффект
+// выглядит одинаково при любой частоте кадров. Для рисования эффекты отдаются
+// картинками атласа (collect), которые рисуются одним draw.
+class EffectPool {
+public:
+    static const int CAPACITY = 64;
+
+private:
+    Effect effects[CAPACITY];
+    int count;                  // живые эффекты - первые count
+
+    static sf::Color lerp(sf::Color a, sf::Color b, float t) {
+        auto channel = [t](sf::Uint8 from, sf::Uint8 to) {
+            return static_cast<sf::Uint8>(from + (to - from) * t + 0.5f);
+        };
+        return sf::Color(channel(a.r, b.r), channel(a.g, b.g), channel(a.b, b.b), channel(a.a, b.a));
+    }
+
+public:
+    EffectPool() : count(0) {
+    }
+
+    // При переполнении заменяется эффект, ближе всех к завершению
+    void spawn(const Effect& effect) {
+        int slot = count;
+        if (count == CAPACITY) {
+            float latest = -1.0f;
+            for (int i = 0; i < CAPACITY; ++i) {
+                float progress = (effects[i].age - effects[i].delay) / effects[i].duration;
+                if (progress > latest) {
+                    latest = progress;
+                    slot = i;
+                }
+            }
+        }
+        else {
+            count++;
+        }
+        effects[slot] = effect;
+        effects[slot].age = 0.0f;
+    }
+
+    void update(float dt) {
+        for (int i = 0; i < count;) {
+            effects[i].age += dt;
+            if (effects[i].age >= effects[i].delay + effects[i].duration) {
+                effects[i] = effects[--count];
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    bool active() const {
+        return count > 0;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    // Добавляет в out начавшиеся эффекты в их текущем виде
+    void collect(std::vector<GlyphSprite>& out) const {
+        for (int i = 0; i < count; ++i) {
+            const Effect& e = effects[i];
+            if (e.age < e.delay) continue;
+            float t = std::min(1.0f, (e.age - e.delay) / e.duration);
+            float size = e.sizeFrom + (e.sizeTo - e.sizeFrom) * applyEase(e.sizeEase, t);
+            GlyphSprite sprite;
+            sprite.glyph = e.glyph;
+            sprite.rect = sf::FloatRect(e.center.x - size / 2, e.center.y - size / 2, size, size);
+            sprite.color = lerp(e.colorFrom, e.colorTo, applyEase(e.colorEase, t));
+            out.push_back(sprite);
+        }
+    }
+};
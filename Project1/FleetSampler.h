@@ -0,0 +1,133 @@
+#pragma once
+#include <cstdint>
+#include <algorithm>
+
+#include "BattleGrid.h"
+#include "Heatmap.h"
+#include "Rng.h"
+
+// То, что стрелок знает о поле противника: без позиций живых кораблей
+struct BoardView {
+    uint16_t unknown[GRID_SIZE];            // не обстрелянные клетки
+    uint16_t hits[GRID_SIZE];               // попадания в еще не потопленные корабли
+    int shipCounts[MAX_SHIP_SIZE + 1];      // оставшиеся корабли по длине
+
+    static BoardView fromGrid(const BattleGrid& grid) {
+        BoardView view;
+        buildUnknownRows(grid, view.unknown);
+        countRemainingShips(grid, view.shipCounts);
+        const auto& cells = grid.getGrid();
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            view.hits[y] = 0;
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                if (cells[y][x] == CellState::Hit) view.hits[y] |= 1u << x;
+            }
+        }
+        return view;
+    }
+
+    bool hasHits() const {
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            if (hits[y]) return true;
+        }
+        return false;
+    }
+};
+
+inline bool placementFits(const uint16_t freeRows[GRID_SIZE], int x, int y, int size, bool horizontal) {
+    if (horizontal) {
+        if (x + size > GRID_SIZE) return false;
+        uint16_t span = static_cast<uint16_t>(((1u << size) - 1) << x);
+        return (freeRows[y] & span) == span;
+    }
+    if (y + size > GRID_SIZE) return false;
+    for (int i = 0; i < size; ++i) {
+        if (!(freeRows[y + i] >> x & 1)) return false;
+    }
+    return true;
+}
+
+inline bool placementCoversHit(const uint16_t hits[GRID_SIZE], int x, int y, int size, bool horizontal) {
+    if (horizontal) {
+        return (hits[y] >> x & ((1u << size) - 1)) != 0;
+    }
+    for (int i = 0; i < size; ++i) {
+        if (hits[y + i] >> x & 1) return true;
+    }
+    return false;
+}
+
+// Корабль вместе с окрестностью исключается из свободных клеток
+inline void occupyPlacement(uint16_t freeRows[GRID_SIZE], uint16_t shipRows[GRID_SIZE], int x, int y, int size, bool horizontal) {
+    int width = horizontal ? size : 1;
+    int height = horizontal ? 1 : size;
+    uint16_t span = static_cast<uint16_t>(((1u << width) - 1) << x);
+    uint16_t halo = static_cast<uint16_t>(span | span << 1 | span >> 1);
+    for (int row = std::max(0, y - 1); row <= std::min(GRID_SIZE - 1, y + height); ++row) {
+        freeRows[row] &= static_cast<uint16_t>(~halo);
+    }
+    for (int row = y; row < y + height; ++row) {
+        shipRows[row] |= span;
+    }
+}
+
+// Случайная расстановка оставшихся кораблей, согласованная с тем, что видит стрелок
+inline bool sampleFleet(const BoardView& view, GameRng& gen, uint16_t shipRows[GRID_SIZE]) {
+    uint16_t freeRows[GRID_SIZE];
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        freeRows[y] = view.unknown[y] | view.hits[y];
+        shipRows[y] = 0;
+    }
+
+    int counts[MAX_SHIP_SIZE + 1];
+    std::copy(view.shipCounts, view.shipCounts + MAX_SHIP_SIZE + 1, counts);
+    bool needHits = view.hasHits();
+
+    const int maxOptions = GRID_SIZE * GRID_SIZE * 2 * MAX_SHIP_SIZE;
+    uint8_t x[maxOptions];
+    uint8_t y[maxOptions];
+    uint8_t sizes[maxOptions];
+    bool horizontal[maxOptions];
+
+    while (true) {
+        // Пока есть непокрытые попадания, ставим корабль через одно из них,
+        // иначе - самый длинный из оставшихся
+        int options = 0;
+
+        int largest = 0;
+        for (int size = MAX_SHIP_SIZE; size >= 1 && !largest; --size) {
+            if (counts[size] > 0) largest = size;
+        }
+        if (!largest) break;
+
+        for (int size = 1; size <= MAX_SHIP_SIZE; ++size) {
+            if (counts[size] == 0 || (!needHits && size != largest)) continue;
+            for (int h = 0; h < (size == 1 ? 1 : 2); ++h) {
+                for (int cy = 0; cy < GRID_SIZE; ++cy) {
+                    for (int cx = 0; cx < GRID_SIZE; ++cx) {
+                        if (!placementFits(freeRows, cx, cy, size, h == 0)) continue;
+                        if (needHits && !placementCoversHit(view.hits, cx, cy, size, h == 0)) continue;
+                        x[options] = static_cast<uint8_t>(cx);
+                        y[options] = static_cast<uint8_t>(cy);
+                        sizes[options] = static_cast<uint8_t>(size);
+                        horizontal[options] = h == 0;
+                        options++;
+                    }
+                }
+            }
+        }
+        if (options == 0) return false;
+
+        int i = randomInt(gen, 0, options - 1);
+        occupyPlacement(freeRows, shipRows, x[i], y[i], sizes[i], horizontal[i]);
+        counts[sizes[i]]--;
+
+        if (needHits) {
+            needHits = false;
+            for (int row = 0; row < GRID_SIZE; ++row) {
+                if (view.hits[row] & static_cast<uint16_t>(~shipRows[row])) needHits = true;
+            }
+        }
+    }
+    return !needHits;
+}
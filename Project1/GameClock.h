@@ -0,0 +1,79 @@
+#pragma once
+#include <chrono>
+
+// Источник игрового времени в секундах. Игра не читает часы напрямую:
+// в обычном режиме время реальное, в ускоренном - умноженное, а в
+// виртуальном идет только по команде (симуляции и автотесты без ожидания).
+class GameClock {
+public:
+    virtual ~GameClock() {}
+    virtual double now() const = 0;
+};
+
+class RealClock : public GameClock {
+private:
+    std::chrono::steady_clock::time_point start;
+
+public:
+    RealClock() : start(std::chrono::steady_clock::now()) {
+    }
+
+    double now() const override {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// Реальное время, ускоренное в scale раз
+class ScaledClock : public GameClock {
+private:
+    RealClock real;
+    double scale;
+
+public:
+    explicit ScaledClock(double speed) : scale(speed) {
+    }
+
+    double now() const override {
+        return real.now() * scale;
+    }
+};
+
+class VirtualClock : public GameClock {
+private:
+    double time;
+
+public:
+    VirtualClock() : time(0.0) {
+    }
+
+    double now() const override {
+        return time;
+    }
+
+    void advance(double seconds) {
+        time += seconds;
+    }
+
+    void setTime(double seconds) {
+        time = seconds;
+    }
+};
+
+// Замена sf::Clock поверх GameClock
+class Stopwatch {
+private:
+    const GameClock* clock;
+    double started;
+
+public:
+    explicit Stopwatch(const GameClock& source) : clock(&source), started(source.now()) {
+    }
+
+    void restart() {
+        started = clock->now();
+    }
+
+    double elapsedSeconds() const {
+        return clock->now() - started;
+    }
+};
@@ -0,0 +1,196 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+#include "BattleGrid.h"
+#include "DrawStats.h"
+
+// Картинки клеток в одной текстуре. Генерируются при первом обращении,
+// поэтому без окна (повтор сессий) текстура не создается. Клетка занимает
+// cellSize логических пикселей, картинка в текстуре - tileSize настоящих:
+// при масштабе окна атлас перерисовывается с нужной четкостью.
+enum class Glyph {
+    Empty,
+    Ship,
+    Hit,
+    Miss,
+    Destroyed,
+    Explosion,  // белый круг, цвет задается вершинами
+    Ring,       // белое кольцо с полупрозрачной серединой (волна)
+    Count
+};
+
+// Корабли противника не показываются
+inline Glyph cellGlyph(CellState state, bool showShips) {
+    switch (state) {
+    case CellState::Ship:
+        return showShips ? Glyph::Ship : Glyph::Empty;
+    case CellState::Hit:
+        return Glyph::Hit;
+    case CellState::Miss:
+        return Glyph::Miss;
+    case CellState::Destroyed:
+        return Glyph::Destroyed;
+    default:
+        return Glyph::Empty;
+    }
+}
+
+class GlyphAtlas {
+private:
+    int cellSize;
+    int tileSize;
+    sf::Texture texture;
+    bool created;
+
+    static sf::Color mix(sf::Color base, sf::Color ink, float coverage) {
+        coverage = std::max(0.0f, std::min(1.0f, coverage));
+        auto channel = [coverage](sf::Uint8 a, sf::Uint8 b) {
+            return static_cast<sf::Uint8>(a + (b - a) * coverage + 0.5f);
+        };
+        return sf::Color(channel(base.r, ink.r), channel(base.g, ink.g), channel(base.b, ink.b), channel(base.a, ink.a));
+    }
+
+    // Расстояние от точки до отрезка
+    static float segmentDistance(sf::Vector2f p, sf::Vector2f a, sf::Vector2f b) {
+        sf::Vector2f ab = b - a, ap = p - a;
+        float t = std::max(0.0f, std::min(1.0f, (ap.x * ab.x + ap.y * ab.y) / (ab.x * ab.x + ab.y * ab.y)));
+        sf::Vector2f d = ap - ab * t;
+        return std::sqrt(d.x * d.x + d.y * d.y);
+    }
+
+    // Пиксель (x, y) картинки glyph; рамка в логический пиксель прозрачная - под ней видна сетка
+    sf::Color pixel(Glyph glyph, int x, int y) const {
+        const float size = static_cast<float>(tileSize);
+        const float k = size / cellSize;    // пикселей текстуры на логический пиксель
+        sf::Vector2f p(x + 0.5f, y + 0.5f);
+        sf::Vector2f center(size / 2, size / 2);
+        float d = std::sqrt((p.x - center.x) * (p.x - center.x) + (p.y - center.y) * (p.y - center.y));
+
+        if (glyph == Glyph::Ring) {
+            float coverage = 1.5f * k - std::fabs(d - (size / 2 - 2.0f * k)) + 0.5f;
+            if (d < size / 2 - 2.0f * k) return mix(sf::Color(255, 255, 255, 60), sf::Color::White, coverage);
+            return mix(sf::Color(255, 255, 255, 0), sf::Color::White, coverage);
+        }
+        if (glyph == Glyph::Explosion) {
+            float radius = size * 0.4f;
+            return mix(sf::Color(255, 255, 255, 0), sf::Color::White, radius - d + 0.5f);
+        }
+        int border = std::max(1, static_cast<int>(k + 0.5f));
+        if (x < border || y < border || x >= tileSize - border || y >= tileSize - border) {
+            return sf::Color::Transparent;
+        }
+
+        sf::Color base = sf::Color::White;
+        if (glyph == Glyph::Ship) base = sf::Color(100, 100, 100);
+        if (glyph == Glyph::Hit) base = sf::Color::Red;
+        if (glyph == Glyph::Miss) base = sf::Color(200, 200, 200);
+        if (glyph == Glyph::Destroyed) base = sf::Color(150, 0, 0);
+
+        if (glyph == Glyph::Hit || glyph == Glyph::Destroyed) {
+            // Крестик с отступом 5 логических пикселей от краев клетки
+            float inset = 5.0f * k;
+            float line = std::min(segmentDistance(p, sf::Vector2f(inset, inset), sf::Vector2f(size - inset, size - inset)),
+                segmentDistance(p, sf::Vector2f(size - inset, inset), sf::Vector2f(inset, size - inset)));
+            return mix(base, sf::Color::Black, k - line);
+        }
+        if (glyph == Glyph::Miss) {
+            return mix(base, sf::Color::Black, size / 8 - d + 0.5f);
+        }
+        return base;
+    }
+
+public:
+    explicit GlyphAtlas(int size) : cellSize(size), tileSize(size), created(false) {
+    }
+
+    int getCellSize() const {
+        return cellSize;
+    }
+
+    // Масштаб окна: при смене размера картинок текстура будет построена заново.
+    // Возвращает true, если координаты картинок в атласе изменились.
+    bool setScale(float scale) {
+        int size = std::max(1, static_cast<int>(cellSize * scale + 0.5f));
+        if (size == tileSize) return false;
+        tileSize = size;
+        created = false;
+        return true;
+    }
+
+    // Картинки стоят в ряд, каждая - tileSize x tileSize пикселей текстуры
+    sf::FloatRect tileRect(Glyph glyph) const {
+        return sf::FloatRect(static_cast<float>(static_cast<int>(glyph) * tileSize), 0.0f,
+            static_cast<float>(tileSize), static_cast<float>(tileSize));
+    }
+
+    const sf::Texture& getTexture() {
+        if (created) return texture;
+        created = true;
+
+        const int count = static_cast<int>(Glyph::Count);
+        sf::Image image;
+        image.create(tileSize * count, tileSize, sf::Color::Transparent);
+        for (int g = 0; g < count; ++g) {
+            for (int y = 0; y < tileSize; ++y) {
+                for (int x = 0; x < tileSize; ++x) {
+                    image.setPixel(g * tileSize + x, y, pixel(static_cast<Glyph>(g), x, y));
+                }
+            }
+        }
+        if (!texture.loadFromImage(image)) {
+            std::cerr << "Failed to create glyph atlas" << std::endl;
+        }
+        texture.setSmooth(true);
+        return texture;
+    }
+
+    // Два треугольника: картинка glyph в прямоугольнике target (логические координаты), умноженная на color
+    void writeQuad(sf::Vertex* v, Glyph glyph, sf::FloatRect target, sf::Color color = sf::Color::White) const {
+        sf::FloatRect tile = tileRect(glyph);
+        sf::Vector2f pos[4] = {
+            { target.left, target.top }, { target.left + target.width, target.top },
+            { target.left + target.width, target.top + target.height }, { target.left, target.top + target.height }
+        };
+        sf::Vector2f uv[4] = {
+            { tile.left, tile.top }, { tile.left + tile.width, tile.top },
+            { tile.left + tile.width, tile.top + tile.height }, { tile.left, tile.top + tile.height }
+        };
+        const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i = 0; i < 6; ++i) {
+            v[i] = sf::Vertex(pos[order[i]], color, uv[order[i]]);
+        }
+    }
+};
+
+// Картинка атласа в прямоугольнике rect (логические координаты), умноженная на color
+struct GlyphSprite {
+    Glyph glyph;
+    sf::FloatRect rect;
+    sf::Color color;
+};
+
+// Рисует набор картинок атласа одним draw. Память вершин растет до самого
+// большого набора и дальше переиспользуется.
+class SpriteBatch {
+private:
+    static const int QUAD_VERTICES = 6;
+
+    std::vector<sf::Vertex> vertices;
+
+public:
+    void draw(sf::RenderTarget& target, GlyphAtlas& atlas, const std::vector<GlyphSprite>& sprites, DrawStats& stats) {
+        if (sprites.empty()) return;
+        if (vertices.size() < sprites.size() * QUAD_VERTICES) {
+            vertices.resize(sprites.size() * QUAD_VERTICES);
+        }
+        for (size_t i = 0; i < sprites.size(); ++i) {
+            atlas.writeQuad(&vertices[i * QUAD_VERTICES], sprites[i].glyph, sprites[i].rect, sprites[i].color);
+        }
+        target.draw(vertices.data(), sprites.size() * QUAD_VERTICES, sf::Triangles, sf::RenderStates(&atlas.getTexture()));
+        stats.add(sprites.size() * QUAD_VERTICES);
+    }
+};
@@ -0,0 +1,289 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+#include "BattleGrid.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HEATMAP_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define HEATMAP_TARGET_SSE2
+#define HEATMAP_TARGET_AVX2
+#else
+#define HEATMAP_TARGET_SSE2 __attribute__((target("sse2")))
+#define HEATMAP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Строка поля - 16 ячеек по 16 бит, используются первые GRID_SIZE
+const int HEATMAP_LANES = 16;
+static_assert(GRID_SIZE <= HEATMAP_LANES, "Row must fit into 16 lanes");
+
+struct PlacementWeights {
+    // [длина - 1][0 - горизонтально, 1 - вертикально][y][x] - вес расстановки, начинающейся в (x, y)
+    alignas(32) uint16_t w[MAX_SHIP_SIZE][2][GRID_SIZE][HEATMAP_LANES];
+
+    PlacementWeights() {
+        fill(1);
+    }
+
+    void fill(uint16_t value) {
+        uint16_t* p = &w[0][0][0][0];
+        for (size_t i = 0; i < sizeof(w) / sizeof(w[0][0][0][0]); ++i) {
+            p[i] = value;
+        }
+    }
+};
+
+struct Heatmap {
+    alignas(32) uint16_t cells[GRID_SIZE][HEATMAP_LANES];
+};
+
+// Битовые маски строк: бит x установлен, если в клетке еще может стоять корабль
+inline void buildUnknownRows(const BattleGrid& grid, uint16_t rows[GRID_SIZE]) {
+    const auto& cells = grid.getGrid();
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        uint16_t row = 0;
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            if (cells[y][x] == CellState::Empty || cells[y][x] == CellState::Ship) {
+                row |= static_cast<uint16_t>(1u << x);
+            }
+        }
+        rows[y] = row;
+    }
+}
+
+// counts[len] - сколько кораблей длины len еще не потоплено (counts[0] не используется)
+inline void countRemainingShips(const BattleGrid& grid, int counts[MAX_SHIP_SIZE + 1]) {
+    for (int len = 0; len <= MAX_SHIP_SIZE; ++len) {
+        counts[len] = 0;
+    }
+    for (const auto& ship : grid.getShips()) {
+        if (!ship.isDestroyed() && ship.size >= 1 && ship.size <= MAX_SHIP_SIZE) {
+            counts[ship.size]++;
+        }
+    }
+}
+
+// Маска допустимых начал расстановки длины len в строке
+inline uint32_t horizontalStarts(uint32_t row, int len) {
+    uint32_t starts = row;
+    for (int k = 1; k < len; ++k) {
+        starts &= row >> k;
+    }
+    return starts;
+}
+
+// Маска допустимых начал вертикальной расстановки длины len со строки y
+inline uint32_t verticalStarts(const uint16_t rows[GRID_SIZE], int y, int len) {
+    if (y + len > GRID_SIZE) return 0;
+    uint32_t starts = rows[y];
+    for (int k = 1; k < len; ++k) {
+        starts &= rows[y + k];
+    }
+    return starts;
+}
+
+// Сумма весов всех допустимых расстановок, накрывающих каждую клетку.
+// Однопалубные корабли учитываются один раз (только как горизонтальные).
+inline void computeHeatmapScalar(const uint16_t rows[GRID_SIZE], const int shipCounts[MAX_SHIP_SIZE + 1],
+    const PlacementWeights& weights, Heatmap& out) {
+    std::memset(out.cells, 0, sizeof(out.cells));
+    const uint32_t boardMask = (1u << GRID_SIZE) - 1;
+
+    for (int len = 1; len <= MAX_SHIP_SIZE; ++len) {
+        if (shipCounts[len] == 0) continue;
+        uint16_t count = static_cast<uint16_t>(shipCounts[len]);
+
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            uint32_t starts = horizontalStarts(rows[y] & boardMask, len);
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                if (!(starts >> x & 1)) continue;
+                uint16_t w = static_cast<uint16_t>(count * weights.w[len - 1][0][y][x]);
+                for (int k = 0; k < len; ++k) {
+                    out.cells[y][x + k] += w;
+                }
+            }
+
+            if (len == 1) continue;
+            uint32_t vstarts = verticalStarts(rows, y, len) & boardMask;
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                if (!(vstarts >> x & 1)) continue;
+                uint16_t w = static_cast<uint16_t>(count * weights.w[len - 1][1][y][x]);
+                for (int k = 0; k < len; ++k) {
+                    out.cells[y + k][x] += w;
+                }
+            }
+        }
+    }
+}
+
+#ifdef HEATMAP_X86
+
+// SSE2: строка хранится в двух регистрах - ячейки 0..7 и 8..15
+template <int K>
+HEATMAP_TARGET_SSE2 inline void shiftLanesUpSse2(__m128i lo, __m128i hi, __m128i& outLo, __m128i& outHi) {
+    outHi = _mm_or_si128(_mm_slli_si128(hi, 2 * K), _mm_srli_si128(lo, 16 - 2 * K));
+    outLo = _mm_slli_si128(lo, 2 * K);
+}
+
+HEATMAP_TARGET_SSE2 inline void expandMaskSse2(uint32_t mask, __m128i& lo, __m128i& hi) {
+    const __m128i bitsLo = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m128i bitsHi = _mm_setr_epi16(256, 512, 1024, 2048, 4096, 8192, 16384, -32768);
+    __m128i m = _mm_set1_epi16(static_cast<short>(mask));
+    lo = _mm_cmpeq_epi16(_mm_and_si128(m, bitsLo), bitsLo);
+    hi = _mm_cmpeq_epi16(_mm_and_si128(m, bitsHi), bitsHi);
+}
+
+HEATMAP_TARGET_SSE2 inline void computeHeatmapSse2(const uint16_t rows[GRID_SIZE], const int shipCounts[MAX_SHIP_SIZE + 1],
+    const PlacementWeights& weights, Heatmap& out) {
+    __m128i accLo[GRID_SIZE];
+    __m128i accHi[GRID_SIZE];
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        accLo[y] = _mm_setzero_si128();
+        accHi[y] = _mm_setzero_si128();
+    }
+    const uint32_t boardMask = (1u << GRID_SIZE) - 1;
+
+    for (int len = 1; len <= MAX_SHIP_SIZE; ++len) {
+        if (shipCounts[len] == 0) continue;
+        const __m128i count = _mm_set1_epi16(static_cast<short>(shipCounts[len]));
+
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            const __m128i* wh = reinterpret_cast<const __m128i*>(weights.w[len - 1][0][y]);
+            __m128i lo, hi;
+            expandMaskSse2(horizontalStarts(rows[y] & boardMask, len), lo, hi);
+            lo = _mm_mullo_epi16(_mm_and_si128(lo, _mm_load_si128(wh)), count);
+            hi = _mm_mullo_epi16(_mm_and_si128(hi, _mm_load_si128(wh + 1)), count);
+
+            // Расстановка с началом в x накрывает клетки x..x+len-1
+            __m128i sumLo = lo, sumHi = hi, sLo, sHi;
+            if (len > 1) { shiftLanesUpSse2<1>(lo, hi, sLo, sHi); sumLo = _mm_add_epi16(sumLo, sLo); sumHi = _mm_add_epi16(sumHi, sHi); }
+            if (len > 2) { shiftLanesUpSse2<2>(lo, hi, sLo, sHi); sumLo = _mm_add_epi16(sumLo, sLo); sumHi = _mm_add_epi16(sumHi, sHi); }
+            if (len > 3) { shiftLanesUpSse2<3>(lo, hi, sLo, sHi); sumLo = _mm_add_epi16(sumLo, sLo); sumHi = _mm_add_epi16(sumHi, sHi); }
+            accLo[y] = _mm_add_epi16(accLo[y], sumLo);
+            accHi[y] = _mm_add_epi16(accHi[y], sumHi);
+
+            if (len == 1) continue;
+            uint32_t vstarts = verticalStarts(rows, y, len) & boardMask;
+            if (vstarts == 0) continue;
+            const __m128i* wv = reinterpret_cast<const __m128i*>(weights.w[len - 1][1][y]);
+            expandMaskSse2(vstarts, lo, hi);
+            lo = _mm_mullo_epi16(_mm_and_si128(lo, _mm_load_si128(wv)), count);
+            hi = _mm_mullo_epi16(_mm_and_si128(hi, _mm_load_si128(wv + 1)), count);
+            for (int k = 0; k < len; ++k) {
+                accLo[y + k] = _mm_add_epi16(accLo[y + k], lo);
+                accHi[y + k] = _mm_add_epi16(accHi[y + k], hi);
+            }
+        }
+    }
+
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        __m128i* dst = reinterpret_cast<__m128i*>(out.cells[y]);
+        _mm_store_si128(dst, accLo[y]);
+        _mm_store_si128(dst + 1, accHi[y]);
+    }
+}
+
+// AVX2: вся строка в одном регистре, сдвиг ячеек через границу 128-битных половин
+template <int K>
+HEATMAP_TARGET_AVX2 inline __m256i shiftLanesUpAvx2(__m256i v) {
+    return _mm256_alignr_epi8(v, _mm256_permute2x128_si256(v, v, 0x08), 16 - 2 * K);
+}
+
+HEATMAP_TARGET_AVX2 inline __m256i expandMaskAvx2(uint32_t mask) {
+    const __m256i bits = _mm256_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128,
+        256, 512, 1024, 2048, 4096, 8192, 16384, -32768);
+    __m256i m = _mm256_set1_epi16(static_cast<short>(mask));
+    return _mm256_cmpeq_epi16(_mm256_and_si256(m, bits), bits);
+}
+
+HEATMAP_TARGET_AVX2 inline void computeHeatmapAvx2(const uint16_t rows[GRID_SIZE], const int shipCounts[MAX_SHIP_SIZE + 1],
+    const PlacementWeights& weights, Heatmap& out) {
+    __m256i acc[GRID_SIZE];
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        acc[y] = _mm256_setzero_si256();
+    }
+    const uint32_t boardMask = (1u << GRID_SIZE) - 1;
+
+    for (int len = 1; len <= MAX_SHIP_SIZE; ++len) {
+        if (shipCounts[len] == 0) continue;
+        const __m256i count = _mm256_set1_epi16(static_cast<short>(shipCounts[len]));
+
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            const __m256i wh = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights.w[len - 1][0][y]));
+            __m256i p = _mm256_mullo_epi16(_mm256_and_si256(expandMaskAvx2(horizontalStarts(rows[y] & boardMask, len)), wh), count);
+
+            __m256i sum = p;
+            if (len > 1) sum = _mm256_add_epi16(sum, shiftLanesUpAvx2<1>(p));
+            if (len > 2) sum = _mm256_add_epi16(sum, shiftLanesUpAvx2<2>(p));
+            if (len > 3) sum = _mm256_add_epi16(sum, shiftLanesUpAvx2<3>(p));
+            acc[y] = _mm256_add_epi16(acc[y], sum);
+
+            if (len == 1) continue;
+            uint32_t vstarts = verticalStarts(rows, y, len) & boardMask;
+            if (vstarts == 0) continue;
+            const __m256i wv = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights.w[len - 1][1][y]));
+            __m256i v = _mm256_mullo_epi16(_mm256_and_si256(expandMaskAvx2(vstarts), wv), count);
+            for (int k = 0; k < len; ++k) {
+                acc[y + k] = _mm256_add_epi16(acc[y + k], v);
+            }
+        }
+    }
+
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out.cells[y]), acc[y]);
+    }
+}
+
+inline bool cpuHasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    // ОС должна сохранять YMM-регистры
+    if ((_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+inline bool cpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif
+
+typedef void (*HeatmapKernel)(const uint16_t rows[GRID_SIZE], const int shipCounts[MAX_SHIP_SIZE + 1],
+    const PlacementWeights& weights, Heatmap& out);
+
+inline HeatmapKernel selectHeatmapKernel() {
+#ifdef HEATMAP_X86
+    if (cpuHasAvx2()) return computeHeatmapAvx2;
+    if (cpuHasSse2()) return computeHeatmapSse2;
+#endif
+    return computeHeatmapScalar;
+}
+
+// Ядро выбирается один раз по возможностям процессора
+inline void computeHeatmap(const uint16_t rows[GRID_SIZE], const int shipCounts[MAX_SHIP_SIZE + 1],
+    const PlacementWeights& weights, Heatmap& out) {
+    static const HeatmapKernel kernel = selectHeatmapKernel();
+    kernel(rows, shipCounts, weights, out);
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <SFML/Window/Event.hpp>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+// Запись сессии для повтора без окна: сид, события ввода и кадры с игровым
+// временем, в конце - итог (число партий и отпечаток состояния игры).
+// Строки: "m t button x y" - нажатие мыши, "k t code" - клавиша, "u t" - кадр,
+// "end games digest".
+
+struct SessionEvent {
+    char kind;      // 'm', 'k' или 'u'
+    double time;
+    int button;
+    int x;
+    int y;
+    int code;
+};
+
+struct SessionRecording {
+    uint64_t seed = 0;
+    std::vector<SessionEvent> events;
+    bool finished = false;
+    int games = 0;
+    uint64_t digest = 0;
+};
+
+class SessionRecorder {
+private:
+    std::ofstream out;
+
+public:
+    bool open(const std::string& fileName, uint64_t seed) {
+        out.open(fileName);
+        if (!out) return false;
+        out.precision(17);
+        out << "SeaBattleSession 1\n" << seed << "\n";
+        return true;
+    }
+
+    bool isOpen() const {
+        return out.is_open();
+    }
+
+    // Пишутся только события, на которые отвечает игра
+    void event(const sf::Event& event, double time) {
+        if (!out.is_open()) return;
+        if (event.type == sf::Event::MouseButtonPressed) {
+            out << "m " << time << " " << event.mouseButton.button << " "
+                << event.mouseButton.x << " " << event.mouseButton.y << "\n";
+        }
+        else if (event.type == sf::Event::KeyPressed) {
+            out << "k " << time << " " << event.key.code << "\n";
+        }
+    }
+
+    void update(double time) {
+        if (!out.is_open()) return;
+        out << "u " << time << "\n";
+    }
+
+    void finish(int games, uint64_t digest) {
+        if (!out.is_open()) return;
+        out << "end " << games << " " << digest << "\n";
+        out.close();
+    }
+};
+
+inline bool loadSession(const std::string& fileName, SessionRecording& session) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    std::string magic;
+    int version = 0;
+    SessionRecording loaded;
+    in >> magic >> version >> loaded.seed;
+    if (!in || magic != "SeaBattleSession" || version != 1) return false;
+
+    std::string kind;
+    while (in >> kind) {
+        SessionEvent e = { kind[0], 0.0, 0, 0, 0, 0 };
+        if (kind == "m") {
+            in >> e.time >> e.button >> e.x >> e.y;
+        }
+        else if (kind == "k") {
+            in >> e.time >> e.code;
+        }
+        else if (kind == "u") {
+            in >> e.time;
+        }
+        else if (kind == "end") {
+            in >> loaded.games >> loaded.digest;
+            loaded.finished = static_cast<bool>(in);
+            break;
+        }
+        else {
+            return false;
+        }
+        if (!in) return false;
+        loaded.events.push_back(e);
+    }
+    session = loaded;
+    return true;
+}
+
+// Событие SFML из записи; для кадров возвращает false
+inline bool toSfEvent(const SessionEvent& e, sf::Event& event) {
+    event = sf::Event();
+    if (e.kind == 'm') {
+        event.type = sf::Event::MouseButtonPressed;
+        event.mouseButton.button = static_cast<sf::Mouse::Button>(e.button);
+        event.mouseButton.x = e.x;
+        event.mouseButton.y = e.y;
+        return true;
+    }
+    if (e.kind == 'k') {
+        event.type = sf::Event::KeyPressed;
+        event.key.code = static_cast<sf::Keyboard::Key>(e.code);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "GlyphAtlas.h"
+#include "Rng.h"
+
+// Параметры одного выброса частиц
+struct ParticleBurst {
+    sf::Vector2f center;
+    int count = 30;
+    float direction = 0.0f;         // средний угол вылета, радианы (0 - вправо, ось y вниз)
+    float spread = 6.2831853f;      // разброс угла; 2 пи - во все стороны
+    float speedMin = 40.0f;         // пикселей в секунду
+    float speedMax = 160.0f;
+    float lifeMin = 0.4f;           // секунды
+    float lifeMax = 0.9f;
+    float size = 6.0f;              // начальный размер, к концу жизни уменьшается до нуля
+    float gravity = 0.0f;           // ускорение вниз, пикселей в секунду за секунду
+    sf::Color color = sf::Color::White;
+};
+
+// Частицы - структура массивов фиксированной емкости, память выделяется один раз
+// в конструкторе. Шаг симуляции - циклы по float-массивам без ветвлений, которые
+// компилятор векторизует; мертвые частицы заменяются последней живой. Для рисования
+// частицы отдаются круглыми картинками атласа (collect), все вместе - один draw.
+class ParticleSystem {
+public:
+    static const int CAPACITY = 4096;
+
+private:
+    std::vector<float> x, y, vx, vy, gravity, life, invLifetime, size;
+    std::vector<sf::Color> color;
+    int count;
+    GameRng gen;    // отдельный поток: частицы не влияют на решения компьютера
+
+    void kill(int i) {
+        int last = --count;
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        gravity[i] = gravity[last];
+        life[i] = life[last];
+        invLifetime[i] = invLifetime[last];
+        size[i] = size[last];
+        color[i] = color[last];
+    }
+
+public:
+    explicit ParticleSystem(uint64_t seed) : x(CAPACITY), y(CAPACITY), vx(CAPACITY), vy(CAPACITY), gravity(CAPACITY),
+        life(CAPACITY), invLifetime(CAPACITY), size(CAPACITY), color(CAPACITY), count(0), gen(seed) {
+    }
+
+    // Лишние частицы при заполненном массиве отбрасываются
+    void emit(const ParticleBurst& burst) {
+        int n = std::min(burst.count, CAPACITY - count);
+        for (int k = 0; k < n; ++k) {
+            int i = count++;
+            float angle = burst.direction + (randomUnit(gen) - 0.5f) * burst.spread;
+            float speed = burst.speedMin + (burst.speedMax - burst.speedMin) * randomUnit(gen);
+            float lifetime = burst.lifeMin + (burst.lifeMax - burst.lifeMin) * randomUnit(gen);
+            x[i] = burst.center.x;
+            y[i] = burst.center.y;
+            vx[i] = std::cos(angle) * speed;
+            vy[i] = std::sin(angle) * speed;
+            gravity[i] = burst.gravity;
+            life[i] = lifetime;
+            invLifetime[i] = 1.0f / lifetime;
+            size[i] = burst.size;
+            color[i] = burst.color;
+        }
+    }
+
+    void update(float dt) {
+        float* px = x.data();
+        float* py = y.data();
+        float* pvx = vx.data();
+        float* pvy = vy.data();
+        const float* pg = gravity.data();
+        float* plife = life.data();
+        for (int i = 0; i < count; ++i) {
+            pvy[i] += pg[i] * dt;
+            px[i] += pvx[i] * dt;
+            py[i] += pvy[i] * dt;
+            plife[i] -= dt;
+        }
+        for (int i = 0; i < count;) {
+            if (plife[i] <= 0.0f) kill(i);
+            else ++i;
+        }
+    }
+
+    bool active() const {
+        return count > 0;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    // Добавляет в out живые частицы: размер и прозрачность убывают к концу жизни
+    void collect(std::vector<GlyphSprite>& out) const {
+        for (int i = 0; i < count; ++i) {
+            float t = life[i] * invLifetime[i];     // доля оставшейся жизни
+            float s = size[i] * t;
+            GlyphSprite sprite;
+            sprite.glyph = Glyph::Explosion;
+            sprite.rect = sf::FloatRect(x[i] - s / 2, y[i] - s / 2, s, s);
+            sprite.color = color[i];
+            sprite.color.a = static_cast<sf::Uint8>(sprite.color.a * t);
+            out.push_back(sprite);
+        }
+    }
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#include "DrawStats.h"
+
+// Число выделений памяти через operator new с запуска программы;
+// увеличивает его замена operator new в Source.cpp. Считается только код
+// самой программы (включая шаблоны SFML, развернутые в ней): библиотеки SFML
+// в своих DLL выделяют память своим operator new, и эти выделения не видны.
+inline std::atomic<uint64_t>& allocationCounter() {
+    static std::atomic<uint64_t> counter(0);
+    return counter;
+}
+
+// Замеры логики за шаг; приходят из потока игры вместе со снимком кадра
+struct SimulationTimings {
+    double updateSeconds = 0.0;     // последний Game::update
+    double aiSeconds = 0.0;         // последнее решение компьютера (chooseTarget)
+};
+
+// Панель производительности (F3): время кадра (среднее и p99), FPS, вызовы draw
+// и вершины, время шага логики и хода ИИ, выделения памяти за кадр. Строки
+// собираются без выделения памяти в один массив вершин на текстуре шрифта и
+// рисуются одним draw; подложка берет белый квадрат, который SFML держит в
+// углу каждой текстуры шрифта.
+class PerfHud {
+private:
+    static const int HISTORY = 120;
+    static const unsigned int CHARACTER_SIZE = 14;
+    static const int MAX_CHARACTERS = 512;
+
+    const sf::Font* font;
+    float frameSeconds[HISTORY];
+    float sorted[HISTORY];
+    int frames;
+    int next;
+
+    double fpsWindow;           // секунды, накопленные для текущего замера FPS
+    int fpsFrames;
+    float fps;
+
+    uint64_t lastAllocations;
+    uint64_t frameAllocations;
+
+    std::vector<sf::Vertex> vertices;
+
+    void writeQuad(sf::Vertex* v, sf::FloatRect rect, sf::FloatRect texture, sf::Color color) {
+        sf::Vector2f pos[4] = {
+            { rect.left, rect.top }, { rect.left + rect.width, rect.top },
+            { rect.left + rect.width, rect.top + rect.height }, { rect.left, rect.top + rect.height }
+        };
+        sf::Vector2f uv[4] = {
+            { texture.left, texture.top }, { texture.left + texture.width, texture.top },
+            { texture.left + texture.width, texture.top + texture.height }, { texture.left, texture.top + texture.height }
+        };
+        const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int i = 0; i < 6; ++i) {
+            v[i] = sf::Vertex(pos[order[i]], color, uv[order[i]]);
+        }
+    }
+
+public:
+    explicit PerfHud(const sf::Font& hudFont) : font(&hudFont), frameSeconds(), sorted(), frames(0), next(0),
+        fpsWindow(0.0), fpsFrames(0), fps(0.0f), lastAllocations(allocationCounter().load()), frameAllocations(0),
+        vertices((MAX_CHARACTERS + 1) * 6) {
+    }
+
+    // Кадр нарисован: seconds - время его рисования, interval - время с прошлого кадра
+    void recordFrame(double seconds, double interval) {
+        frameSeconds[next] = static_cast<float>(seconds);
+        next = (next + 1) % HISTORY;
+        frames = std::min(frames + 1, HISTORY);
+
+        fpsWindow += interval;
+        fpsFrames++;
+        if (fpsWindow >= 1.0) {
+            fps = static_cast<float>(fpsFrames / fpsWindow);
+            fpsWindow = 0.0;
+            fpsFrames = 0;
+        }
+
+        uint64_t allocations = allocationCounter().load(std::memory_order_relaxed);
+        frameAllocations = allocations - lastAllocations;
+        lastAllocations = allocations;
+    }
+
+    // Рисует панель в левом верхнем углу окна, в пикселях окна
+    void draw(sf::RenderTarget& target, const DrawStats& stats, const SimulationTimings& timings) {
+        double average = 0.0;
+        for (int i = 0; i < frames; ++i) {
+            average += frameSeconds[i];
+            sorted[i] = frameSeconds[i];
+        }
+        float p99 = 0.0f;
+        if (frames > 0) {
+            average /= frames;
+            int index = std::min(frames - 1, frames * 99 / 100);
+            std::nth_element(sorted, sorted + index, sorted + frames);
+            p99 = sorted[index];
+        }
+
+        char text[MAX_CHARACTERS];
+        std::snprintf(text, sizeof(text),
+            "frame %.2f ms avg, %.2f ms p99\nfps %.0f\ndraw calls %d, vertices %u\n"
+            "update %.3f ms, AI move %.3f ms\nallocations/frame %u (game code only)",
+            1e3 * average, 1e3 * p99, fps, stats.drawCalls, static_cast<unsigned int>(stats.vertices),
+            1e3 * timings.updateSeconds, 1e3 * timings.aiSeconds, static_cast<unsigned int>(frameAllocations));
+
+        // Сначала глифы: getGlyph может дорисовать их в текстуру шрифта
+        const float padding = 6.0f;
+        const float lineSpacing = font->getLineSpacing(CHARACTER_SIZE);
+        float x = padding;
+        float y = padding + CHARACTER_SIZE;
+        float width = 0.0f;
+        int quads = 1;      // первый четырехугольник - подложка
+        for (const char* c = text; *c != '\0'; ++c) {
+            if (*c == '\n') {
+                x = padding;
+                y += lineSpacing;
+                continue;
+            }
+            const sf::Glyph& glyph = font->getGlyph(static_cast<sf::Uint8>(*c), CHARACTER_SIZE, false);
+            sf::FloatRect rect(x + glyph.bounds.left, y + glyph.bounds.top, glyph.bounds.width, glyph.bounds.height);
+            sf::FloatRect texture(static_cast<float>(glyph.textureRect.left), static_cast<float>(glyph.textureRect.top),
+                static_cast<float>(glyph.textureRect.width), static_cast<float>(glyph.textureRect.height));
+            writeQuad(&vertices[quads * 6], rect, texture, sf::Color::White);
+            quads++;
+            x += glyph.advance;
+            width = std::max(width, x);
+        }
+        writeQuad(&vertices[0], sf::FloatRect(0, 0, width + padding, y + lineSpacing - CHARACTER_SIZE + padding),
+            sf::FloatRect(1, 1, 0, 0), sf::Color(0, 0, 0, 170));
+
+        sf::Vector2u size = target.getSize();
+        target.setView(sf::View(sf::FloatRect(0, 0, static_cast<float>(size.x), static_cast<float>(size.y))));
+        target.draw(vertices.data(), quads * 6, sf::Triangles, sf::RenderStates(&font->getTexture(CHARACTER_SIZE)));
+    }
+};
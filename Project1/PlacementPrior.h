@@ -0,0 +1,118 @@
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BattleGrid.h"
+#include "Heatmap.h"
+
+// Целочисленный масштаб весов расстановок в карте плотности
+const int PRIOR_WEIGHT_SCALE = 8;
+
+// Накопленная статистика расстановок игрока между сессиями.
+// С пустым именем файла статистика живет только в памяти.
+class PlacementPrior {
+private:
+    std::string fileName;
+    bool loaded;
+    int games;
+    std::vector<int> cellCounts;      // [y][x]
+    std::vector<int> placementCounts; // [size - 1][horizontal][y][x]
+
+    static int placementIndex(int size, bool horizontal, int x, int y) {
+        // Однопалубные корабли не имеют ориентации - храним их как горизонтальные
+        if (size == 1) horizontal = true;
+        return (((size - 1) * 2 + (horizontal ? 1 : 0)) * GRID_SIZE + y) * GRID_SIZE + x;
+    }
+
+    void ensureLoaded() {
+        if (loaded) return;
+        loaded = true;
+        if (fileName.empty()) return;
+
+        std::ifstream in(fileName);
+        if (!in) return;
+
+        std::string magic;
+        int version = 0;
+        int loadedGames = 0;
+        std::vector<int> cells(cellCounts.size());
+        std::vector<int> placements(placementCounts.size());
+        in >> magic >> version >> loadedGames;
+        for (int& c : cells) in >> c;
+        for (int& c : placements) in >> c;
+
+        if (!in || magic != "SeaBattlePrior" || version != 1) {
+            std::cerr << "Failed to load placement prior" << std::endl;
+            return;
+        }
+        games = loadedGames;
+        cellCounts = cells;
+        placementCounts = placements;
+    }
+
+    void save() const {
+        if (fileName.empty()) return;
+        std::ofstream out(fileName);
+        if (!out) {
+            std::cerr << "Failed to save placement prior" << std::endl;
+            return;
+        }
+        out << "SeaBattlePrior 1\n" << games << "\n";
+        for (int c : cellCounts) out << c << ' ';
+        out << "\n";
+        for (int c : placementCounts) out << c << ' ';
+        out << "\n";
+    }
+
+public:
+    explicit PlacementPrior(const std::string& file) : fileName(file), loaded(false), games(0),
+        cellCounts(GRID_SIZE * GRID_SIZE, 0),
+        placementCounts(MAX_SHIP_SIZE * 2 * GRID_SIZE * GRID_SIZE, 0) {
+    }
+
+    // Вызывается в конце партии: обновление O(кораблей), затем запись на диск
+    void record(const BattleGrid& grid) {
+        ensureLoaded();
+        for (const auto& ship : grid.getShips()) {
+            if (ship.size < 1 || ship.size > MAX_SHIP_SIZE) continue;
+            const auto& start = ship.positions.front();
+            placementCounts[placementIndex(ship.size, ship.horizontal, start.first, start.second)]++;
+            for (const auto& pos : ship.positions) {
+                cellCounts[pos.second * GRID_SIZE + pos.first]++;
+            }
+        }
+        games++;
+        save();
+    }
+
+    // Частота, с которой игрок ставил такой корабль именно сюда (0..1)
+    float placementFrequency(int size, bool horizontal, int x, int y) {
+        ensureLoaded();
+        if (games == 0 || size < 1 || size > MAX_SHIP_SIZE) return 0.0f;
+        return static_cast<float>(placementCounts[placementIndex(size, horizontal, x, y)]) / games;
+    }
+
+    // Целочисленные веса расстановок для ядра карты плотности
+    void fillWeights(PlacementWeights& weights, float placementWeight) {
+        for (int size = 1; size <= MAX_SHIP_SIZE; ++size) {
+            for (int h = 0; h < 2; ++h) {
+                for (int y = 0; y < GRID_SIZE; ++y) {
+                    for (int x = 0; x < HEATMAP_LANES; ++x) {
+                        float freq = x < GRID_SIZE ? placementFrequency(size, h == 0, x, y) : 0.0f;
+                        weights.w[size - 1][h][y][x] = static_cast<uint16_t>(
+                            PRIOR_WEIGHT_SCALE * (1.0f + placementWeight * freq) + 0.5f);
+                    }
+                }
+            }
+        }
+    }
+
+    // Частота, с которой клетка была занята кораблем игрока (0..1)
+    float cellFrequency(int x, int y) {
+        ensureLoaded();
+        if (games == 0) return 0.0f;
+        return static_cast<float>(cellCounts[y * GRID_SIZE + x]) / games;
+    }
+};
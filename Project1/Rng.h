@@ -0,0 +1,166 @@
+#pragma once
+#include <cstdint>
+
+// Быстрые генераторы с маленьким состоянием и явным сидом.
+// Оба подходят как UniformRandomBitGenerator. Генератор игры выбирается
+// при сборке: по умолчанию xoshiro256**, с SEABATTLE_RNG_PCG - PCG32.
+
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Сид потока (seed, a, b): разные номера дают независимые последовательности
+inline uint64_t streamSeed(uint64_t seed, uint64_t a, uint64_t b) {
+    uint64_t state = seed;
+    uint64_t mixed = splitMix64(state);
+    state = mixed ^ a;
+    mixed = splitMix64(state);
+    state = mixed ^ b;
+    return splitMix64(state);
+}
+
+// xoshiro256** (Blackman, Vigna): 32 байта состояния
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t value = 0) {
+        seed(value);
+    }
+
+    void seed(uint64_t value) {
+        for (int i = 0; i < 4; ++i) {
+            s[i] = splitMix64(value);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    result_type operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Сдвиг на 2^128 шагов: непересекающиеся подпоследовательности из одного сида
+    void jump() {
+        static const uint64_t JUMP[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+            0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+        uint64_t t[4] = { 0, 0, 0, 0 };
+        for (uint64_t jump : JUMP) {
+            for (int b = 0; b < 64; ++b) {
+                if (jump & (1ull << b)) {
+                    for (int i = 0; i < 4; ++i) t[i] ^= s[i];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) s[i] = t[i];
+    }
+
+    static Xoshiro256 forStream(uint64_t seed, uint64_t a, uint64_t b = 0) {
+        return Xoshiro256(streamSeed(seed, a, b));
+    }
+
+    // Дочерний генератор; родитель продвигается, поэтому повторный split дает другой поток
+    Xoshiro256 split() {
+        return Xoshiro256((*this)());
+    }
+};
+
+// PCG32 (O'Neill, XSH RR): 16 байт состояния
+class Pcg32 {
+private:
+    uint64_t state;
+    uint64_t inc;
+
+public:
+    typedef uint32_t result_type;
+
+    explicit Pcg32(uint64_t value = 0, uint64_t stream = 0) {
+        seed(value, stream);
+    }
+
+    void seed(uint64_t value, uint64_t stream = 0) {
+        state = 0;
+        inc = (stream << 1) | 1;
+        (*this)();
+        state += value;
+        (*this)();
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~static_cast<result_type>(0); }
+
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    static Pcg32 forStream(uint64_t seed, uint64_t a, uint64_t b = 0) {
+        uint64_t mixed = streamSeed(seed, a, b);
+        uint64_t state = mixed;
+        return Pcg32(mixed, splitMix64(state));
+    }
+
+    Pcg32 split() {
+        uint64_t value = (static_cast<uint64_t>((*this)()) << 32) | (*this)();
+        uint64_t state = value;
+        return Pcg32(value, splitMix64(state));
+    }
+};
+
+#ifdef SEABATTLE_RNG_PCG
+typedef Pcg32 GameRng;
+#else
+typedef Xoshiro256 GameRng;
+#endif
+
+// Старшие 32 бита результата генератора
+template <class Rng>
+inline uint32_t randomBits32(Rng& rng) {
+    return static_cast<uint32_t>(rng() >> (sizeof(typename Rng::result_type) * 8 - 32));
+}
+
+// Равномерное целое из [low, high] (метод Лемира). В отличие от
+// std::uniform_int_distribution дает одинаковые числа на всех компиляторах.
+template <class Rng>
+inline int randomInt(Rng& rng, int low, int high) {
+    uint32_t range = static_cast<uint32_t>(high - low) + 1;
+    uint64_t m = static_cast<uint64_t>(randomBits32(rng)) * range;
+    uint32_t leftover = static_cast<uint32_t>(m);
+    if (leftover < range) {
+        uint32_t threshold = (0u - range) % range;
+        while (leftover < threshold) {
+            m = static_cast<uint64_t>(randomBits32(rng)) * range;
+            leftover = static_cast<uint32_t>(m);
+        }
+    }
+    return low + static_cast<int>(m >> 32);
+}
+
+// Равномерное число из [0, 1)
+template <class Rng>
+inline float randomUnit(Rng& rng) {
+    return (randomBits32(rng) >> 8) * (1.0f / 16777216.0f);
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <algorithm>
+
+#include "BattleGrid.h"
+#include "Heatmap.h"
+#include "Rng.h"
+#include "FleetSampler.h"
+#include "TripleBuffer.h"
+
+struct HintResult {
+    uint32_t generation = 0;        // номер запроса, для которого посчитан результат
+    bool valid = false;
+    float heat[GRID_SIZE][GRID_SIZE];   // 0..1, только для необстрелянных клеток
+    int bestX = 0;
+    int bestY = 0;
+    int samples = 0;                // 0 - оценка ядром карты плотности, иначе число расстановок Монте-Карло
+};
+
+// Подсказки выстрела для игрока. Считаются в фоновом потоке: сначала ядро карты
+// плотности ИИ, затем уточнение выборкой согласованных расстановок флота пакетами.
+// Между пакетами поток проверяет, не отменен ли запрос. Готовые результаты
+// публикуются через тройной буфер: игра никогда не ждет вычислений.
+class ShotHintEngine {
+private:
+    static const int SAMPLE_BATCH = 256;
+    static const int MAX_SAMPLES = 20000;
+    static const int MIN_DISPLAY_SAMPLES = 200;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+    BoardView pendingView;
+    uint32_t pendingGeneration;
+
+    std::atomic<uint32_t> generation;   // последний запрос; больший номер отменяет текущий расчет
+    std::atomic<uint32_t> requested;    // номер последнего request
+    std::atomic<uint32_t> completed;    // номер последнего законченного расчета
+
+    TripleBuffer<HintResult> results;
+
+    GameRng gen;
+    PlacementWeights uniformWeights;
+
+    bool cancelled(uint32_t requestGeneration) const {
+        return generation.load(std::memory_order_relaxed) != requestGeneration;
+    }
+
+    void publish(const HintResult& result) {
+        results.writeBuffer() = result;
+        results.publish();
+    }
+
+    static void finishResult(const BoardView& view, const float raw[GRID_SIZE][GRID_SIZE], HintResult& result) {
+        float maxHeat = 0.0f;
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                if (view.unknown[y] >> x & 1) maxHeat = std::max(maxHeat, raw[y][x]);
+            }
+        }
+
+        float best = -1.0f;
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                bool open = (view.unknown[y] >> x & 1) != 0;
+                result.heat[y][x] = open && maxHeat > 0 ? raw[y][x] / maxHeat : 0.0f;
+                if (open && raw[y][x] > best) {
+                    best = raw[y][x];
+                    result.bestX = x;
+                    result.bestY = y;
+                }
+            }
+        }
+        result.valid = best >= 0.0f;
+    }
+
+    // Первая оценка: то же ядро, что и у ИИ. При ранениях учитываем расстановки
+    // через попадания и предлагаем только клетки рядом с ними.
+    void kernelEstimate(const BoardView& view, HintResult& result) {
+        uint16_t rows[GRID_SIZE];
+        bool wounded = view.hasHits();
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            rows[y] = view.unknown[y] | view.hits[y];
+        }
+
+        Heatmap heatmap;
+        computeHeatmap(rows, view.shipCounts, uniformWeights, heatmap);
+
+        float raw[GRID_SIZE][GRID_SIZE];
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                raw[y][x] = heatmap.cells[y][x];
+                if (wounded) {
+                    bool nearHit = (x > 0 && (view.hits[y] >> (x - 1) & 1)) ||
+                        (x < GRID_SIZE - 1 && (view.hits[y] >> (x + 1) & 1)) ||
+                        (y > 0 && (view.hits[y - 1] >> x & 1)) ||
+                        (y < GRID_SIZE - 1 && (view.hits[y + 1] >> x & 1));
+                    if (!nearHit) raw[y][x] *= 0.01f;
+                }
+            }
+        }
+        finishResult(view, raw, result);
+    }
+
+    void compute(const BoardView& view, uint32_t requestGeneration) {
+        HintResult result;
+        result.generation = requestGeneration;
+        kernelEstimate(view, result);
+        publish(result);
+
+        float counts[GRID_SIZE][GRID_SIZE] = {};
+        int accepted = 0;
+        for (int attempts = 0; attempts < MAX_SAMPLES && !cancelled(requestGeneration); attempts += SAMPLE_BATCH) {
+            for (int i = 0; i < SAMPLE_BATCH; ++i) {
+                uint16_t shipRows[GRID_SIZE];
+                if (!sampleFleet(view, gen, shipRows)) continue;
+                accepted++;
+                for (int y = 0; y < GRID_SIZE; ++y) {
+                    for (int x = 0; x < GRID_SIZE; ++x) {
+                        counts[y][x] += shipRows[y] >> x & 1;
+                    }
+                }
+            }
+
+            if (accepted >= MIN_DISPLAY_SAMPLES && !cancelled(requestGeneration)) {
+                result.samples = accepted;
+                finishResult(view, counts, result);
+                publish(result);
+            }
+        }
+    }
+
+    void run() {
+        uint32_t done = 0;
+        while (true) {
+            BoardView view;
+            uint32_t requestGeneration;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, done]() { return stopping || pendingGeneration != done; });
+                if (stopping) return;
+                view = pendingView;
+                requestGeneration = pendingGeneration;
+            }
+            done = requestGeneration;
+            if (!cancelled(requestGeneration)) {
+                compute(view, requestGeneration);
+            }
+            completed.store(requestGeneration, std::memory_order_release);
+        }
+    }
+
+public:
+    explicit ShotHintEngine(uint64_t seed) : stopping(false), pendingGeneration(0), generation(0), requested(0), completed(0),
+        gen(seed) {
+        uniformWeights.fill(1);
+        worker = std::thread(&ShotHintEngine::run, this);
+    }
+
+    ~ShotHintEngine() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        generation++;
+        wake.notify_one();
+        worker.join();
+    }
+
+    ShotHintEngine(const ShotHintEngine&) = delete;
+    ShotHintEngine& operator=(const ShotHintEngine&) = delete;
+
+    // Новый расчет; предыдущий прерывается на ближайшей границе пакета
+    uint32_t request(const BoardView& view) {
+        uint32_t requestGeneration;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requestGeneration = ++generation;
+            requested.store(requestGeneration, std::memory_order_relaxed);
+            pendingView = view;
+            pendingGeneration = requestGeneration;
+        }
+        wake.notify_one();
+        return requestGeneration;
+    }
+
+    // Отмена без нового запроса (игрок выстрелил)
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        generation++;
+    }
+
+    // Идет расчет последнего запроса: результаты еще будут публиковаться
+    bool busy() const {
+        uint32_t current = generation.load(std::memory_order_relaxed);
+        return requested.load(std::memory_order_relaxed) == current &&
+            completed.load(std::memory_order_acquire) != current;
+    }
+
+    // Последний готовый результат, без блокировок. Для отмененных запросов valid == false.
+    const HintResult& latestResult() {
+        results.fetch();
+        HintResult& result = results.readBuffer();
+        if (result.generation != generation.load(std::memory_order_relaxed)) {
+            result.valid = false;
+        }
+        return result;
+    }
+};
@@ -5,24 +5,60 @@
 #include <random>
 #include <string>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+#include <new>
+
+#include "BattleGrid.h"
+#include "ComputerPlayer.h"
+#include "ShotHints.h"
+#include "GameClock.h"
+#include "InputRecording.h"
+#include "GlyphAtlas.h"
+#include "BoardMesh.h"
+#include "Widgets.h"
+#include "Effects.h"
+#include "Particles.h"
+#include "TripleBuffer.h"
+#include "PerfHud.h"
+
+// Замена operator new только считает выделения памяти для панели производительности.
+// Действует на этот исполняемый файл: выделения внутри DLL SFML сюда не попадают.
+void* operator new(std::size_t size) {
+    allocationCounter().fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
 
 const int CELL_SIZE = 40;
 const int MARGIN = 50;
 const int GRID_OFFSET_X = MARGIN;
 const int GRID_OFFSET_Y = MARGIN;
-const int GRID_SIZE = 10;
 const int WINDOW_WIDTH = 2 * MARGIN + 2 * GRID_SIZE * CELL_SIZE + MARGIN;
 const int WINDOW_HEIGHT = MARGIN + GRID_SIZE * CELL_SIZE + MARGIN + 200;
 
-enum class CellState {
-    Empty,
-    Ship,
-    Hit,
-    Miss,
-    Destroyed
-};
+// Кнопки: по одним и тем же прямоугольникам кнопка рисуется и проверяется нажатие
+const sf::FloatRect EASY_BUTTON(WINDOW_WIDTH / 2 - 100, 100, 80, 40);
+const sf::FloatRect MEDIUM_BUTTON(WINDOW_WIDTH / 2 - 10, 100, 80, 40);
+const sf::FloatRect HARD_BUTTON(WINDOW_WIDTH / 2 + 80, 100, 100, 40);
+const sf::FloatRect ROTATE_BUTTON(WINDOW_WIDTH / 2 - 50, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 20, 100, 40);
 
 enum class GameState {
     PlayerTurn,
@@ -30,297 +66,233 @@ enum class GameState {
     PlayerWins,
     ComputerWins,
     ShipPlacement,
-    DifficultySelection,
-    Animation
+    DifficultySelection
 };
 
-enum class Difficulty {
-    Easy,
-    Medium,
-    Hard
-};
-
-class Ship {
-public:
-    int size;
-    bool horizontal;
-    std::vector<std::pair<int, int>> positions;
-    std::vector<bool> hits;
-
-    Ship(int s, bool h, int x, int y) : size(s), horizontal(h) {
-        for (int i = 0; i < size; ++i) {
-            if (horizontal) {
-                positions.emplace_back(x + i, y);
-            }
-            else {
-                positions.emplace_back(x, y + i);
-            }
-            hits.push_back(false);
-        }
-    }
-
-    bool isDestroyed() const {
-        for (bool hit : hits) {
-            if (!hit) return false;
-        }
-        return true;
-    }
+// Все, что нужно для рисования кадра. Игра заполняет снимок и публикует его,
+// поток рисования только читает: общего изменяемого состояния у них нет.
+struct FrameSnapshot {
+    int screen = 0;                 // 0 - выбор сложности, 1 - расстановка, 2 - бой
+    // Клетки полей: заполнены только отмеченные в масках, то есть изменившиеся
+    // с последнего снимка, который дошел до потока рисования
+    CellState playerCells[GRID_SIZE][GRID_SIZE] = {};
+    CellState computerCells[GRID_SIZE][GRID_SIZE] = {};
+    DirtyMask playerDirty;
+    DirtyMask computerDirty;
+    std::string status;
+    std::string playerShips;
+    std::string computerShips;
+    std::string shipSize;
+    bool showHints = false;
+    HintResult hint;
+    std::vector<GlyphSprite> sprites;   // эффекты и частицы
+    bool showHud = false;
+    SimulationTimings timings;
+    sf::View view;
+    float scale = 1.0f;
 };
 
-class BattleGrid {
+class Game {
 private:
-    std::vector<std::vector<CellState>> grid;
-    std::vector<Ship> ships;
+    BattleGrid playerGrid;
+    BattleGrid computerGrid;
+    GameState state;
+    Difficulty difficulty;
+    int currentShipSize;
+    bool currentShipHorizontal;
+    std::vector<int> shipSizes;
+    int playerShipsLeft;
+    int computerShipsLeft;
 
-public:
-    BattleGrid() {
-        grid.resize(GRID_SIZE, std::vector<CellState>(GRID_SIZE, CellState::Empty));
+    // Тексты надписей; выводит их GameRenderer по снимку
+    std::string statusString;
+    std::string playerShipsString;
+    std::string computerShipsString;
+    std::string shipSizeString;
+
+    // Эффекты выстрелов идут по времени и не задерживают ход
+    EffectPool effects;
+    ParticleSystem particles;
+    Stopwatch frameTimer;
+    Stopwatch computerTurnClock;
+
+    // Компьютерный противник
+    ComputerPlayer computer;
+    AiParams aiParams;
+    PlacementPrior placementPrior;
+
+    // Подсказки выстрела для игрока (клавиша H)
+    ShotHintEngine hints;
+    bool hintsEnabled;
+    bool hintsDirty;
+
+    // Панель производительности (клавиша F3) и замеры для нее
+    bool hudVisible;
+    SimulationTimings timings;
+
+    // Раскладка задана в логических пикселях (WINDOW_WIDTH x WINDOW_HEIGHT);
+    // вид вписывает ее в окно любого размера, viewScale - настоящих пикселей на логический
+    sf::View view;
+    float viewScale;
+
+    // Генератор случайных чисел: каждая партия сессии - отдельный поток от общего сида
+    uint64_t seed;
+    int gamesStarted;
+    GameRng gen;
+
+    // Центр клетки (x, y) на поле, по которому стреляли
+    sf::Vector2f cellCenter(int x, int y, bool enemyBoard) const {
+        float left = static_cast<float>(enemyBoard ? GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN : GRID_OFFSET_X);
+        return sf::Vector2f(left + x * CELL_SIZE + CELL_SIZE / 2.0f, GRID_OFFSET_Y + y * CELL_SIZE + CELL_SIZE / 2.0f);
     }
 
-    void clear() {
-        for (auto& row : grid) {
-            for (auto& cell : row) {
-                cell = CellState::Empty;
-            }
+    // Взрыв, волна и частицы в клетке выстрела: искры при попадании, брызги при промахе.
+    // При потоплении корабль гаснет вспышкой по клеткам и разлетается обломками.
+    void spawnShotEffects(int x, int y, bool enemyBoard, CellState result, const BattleGrid& grid) {
+        Effect explosion;
+        explosion.glyph = Glyph::Explosion;
+        explosion.center = cellCenter(x, y, enemyBoard);
+        explosion.duration = 0.5f;
+        explosion.sizeTo = CELL_SIZE;
+        explosion.sizeEase = Ease::OutCubic;
+        explosion.colorFrom = sf::Color(255, 165, 0, 200);
+        explosion.colorTo = sf::Color(255, 165, 0, 0);
+        effects.spawn(explosion);
+
+        Effect ripple;
+        ripple.glyph = Glyph::Ring;
+        ripple.center = explosion.center;
+        ripple.duration = 0.35f;
+        ripple.sizeFrom = 2.0f;
+        ripple.sizeTo = 100.0f;
+        ripple.sizeEase = Ease::OutQuad;
+        ripple.colorFrom = sf::Color(0, 0, 255, 200);
+        ripple.colorTo = sf::Color(0, 0, 255, 0);
+        effects.spawn(ripple);
+
+        ParticleBurst burst;
+        burst.center = explosion.center;
+        if (result == CellState::Miss) {
+            burst.count = 24;
+            burst.direction = -1.5707963f;
+            burst.spread = 1.4f;
+            burst.speedMin = 60.0f;
+            burst.speedMax = 140.0f;
+            burst.gravity = 400.0f;
+            burst.size = 5.0f;
+            burst.color = sf::Color(40, 110, 255, 220);
         }
-        ships.clear();
-    }
+        else {
+            burst.count = 40;
+            burst.size = 6.0f;
+            burst.color = sf::Color(255, 150, 0, 230);
+        }
+        particles.emit(burst);
 
-    bool canPlaceShip(int x, int y, int size, bool horizontal) const {
-        if (horizontal) {
-            if (x + size > GRID_SIZE) return false;
-            for (int i = x - 1; i <= x + size; ++i) {
-                for (int j = y - 1; j <= y + 1; ++j) {
-                    if (i >= 0 && i < GRID_SIZE && j >= 0 && j < GRID_SIZE) {
-                        if (grid[j][i] != CellState::Empty) return false;
-                    }
-                }
-            }
+        if (result != CellState::Destroyed) {
+            return;
         }
-        else {
-            if (y + size > GRID_SIZE) return false;
-            for (int i = x - 1; i <= x + 1; ++i) {
-                for (int j = y - 1; j <= y + size; ++j) {
-                    if (i >= 0 && i < GRID_SIZE && j >= 0 && j < GRID_SIZE) {
-                        if (grid[j][i] != CellState::Empty) return false;
-                    }
-                }
+        for (const auto& ship : grid.getShips()) {
+            if (std::find(ship.positions.begin(), ship.positions.end(), std::make_pair(x, y)) == ship.positions.end()) continue;
+            for (size_t i = 0; i < ship.positions.size(); ++i) {
+                Effect fade;
+                fade.glyph = Glyph::Empty;
+                fade.center = cellCenter(ship.positions[i].first, ship.positions[i].second, enemyBoard);
+                fade.delay = 0.05f * i;
+                fade.duration = 0.6f;
+                fade.sizeFrom = CELL_SIZE;
+                fade.sizeTo = CELL_SIZE;
+                fade.colorFrom = sf::Color(255, 80, 0, 180);
+                fade.colorTo = sf::Color(255, 80, 0, 0);
+                fade.colorEase = Ease::InQuad;
+                effects.spawn(fade);
+
+                ParticleBurst debris;
+                debris.center = fade.center;
+                debris.count = 60;
+                debris.speedMax = 220.0f;
+                debris.lifeMax = 1.2f;
+                debris.gravity = 150.0f;
+                debris.size = 7.0f;
+                debris.color = sf::Color(120, 20, 0, 230);
+                particles.emit(debris);
             }
         }
-        return true;
     }
 
-    bool placeShip(int x, int y, int size, bool horizontal) {
-        if (!canPlaceShip(x, y, size, horizontal)) return false;
-
-        Ship ship(size, horizontal, x, y);
-        ships.push_back(ship);
-
-        for (const auto& pos : ship.positions) {
-            grid[pos.second][pos.first] = CellState::Ship;
-        }
-        return true;
-    }
+    // Выстрел решается сразу, эффекты играют поверх следующего хода
+    void fireAt(int x, int y, bool isPlayer) {
+        if (isPlayer) {
+            // Выстрел игрока меняет поле противника - текущий расчет подсказки уже не нужен
+            hints.cancel();
+            hintsDirty = true;
 
-    CellState attack(int x, int y) {
-        if (grid[y][x] == CellState::Ship) {
-            grid[y][x] = CellState::Hit;
+            CellState result = computerGrid.attack(x, y);
+            spawnShotEffects(x, y, true, result, computerGrid);
 
-            for (auto& ship : ships) {
-                for (int i = 0; i < ship.positions.size(); ++i) {
-                    if (ship.positions[i].first == x && ship.positions[i].second == y) {
-                        ship.hits[i] = true;
-                        if (ship.isDestroyed()) {
-                            markAroundDestroyedShip(ship);
-                            return CellState::Destroyed;
-                        }
-                        return CellState::Hit;
-                    }
-                }
+            if (computerGrid.allShipsDestroyed()) {
+                state = GameState::PlayerWins;
             }
-        }
-        else if (grid[y][x] == CellState::Empty) {
-            grid[y][x] = CellState::Miss;
-            return CellState::Miss;
-        }
-        return grid[y][x];
-    }
-
-    void markAroundDestroyedShip(const Ship& ship) {
-        for (const auto& pos : ship.positions) {
-            for (int x = pos.first - 1; x <= pos.first + 1; ++x) {
-                for (int y = pos.second - 1; y <= pos.second + 1; ++y) {
-                    if (x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE) {
-                        if (grid[y][x] == CellState::Empty) {
-                            grid[y][x] = CellState::Miss;
-                        }
-                    }
-                }
+            else if (result == CellState::Miss) {
+                state = GameState::ComputerTurn;
+                computerTurnClock.restart();
+            }
+            else {
+                // Если игрок попал, он продолжает ходить
+                state = GameState::PlayerTurn;
             }
-            grid[pos.second][pos.first] = CellState::Destroyed;
-        }
-    }
-
-    bool allShipsDestroyed() const {
-        for (const auto& ship : ships) {
-            if (!ship.isDestroyed()) return false;
         }
-        return true;
-    }
-
-    const std::vector<std::vector<CellState>>& getGrid() const {
-        return grid;
-    }
-
-    const std::vector<Ship>& getShips() const {
-        return ships;
-    }
-};
+        else {
+            CellState result = playerGrid.attack(x, y);
+            spawnShotEffects(x, y, false, result, playerGrid);
 
-class Game {
-private:
-    BattleGrid playerGrid;
-    BattleGrid computerGrid;
-    GameState state;
-    Difficulty difficulty;
-    int currentShipSize;
-    bool currentShipHorizontal;
-    std::vector<int> shipSizes;
-    sf::Font font;
-    sf::Text statusText;
-    sf::Text playerShipsText;
-    sf::Text computerShipsText;
-    sf::Text difficultyText;
-    int playerShipsLeft;
-    int computerShipsLeft;
+            computer.onAttackResult(playerGrid, x, y, result);
 
-    //  
-    sf::Clock animationClock;
-    sf::Clock computerTurnClock;
-    float animationProgress;
-    std::pair<int, int> animationTarget;
-    bool isPlayerAnimation;
-    sf::CircleShape rippleEffect;
-    bool showRipple;
-    sf::Vector2f ripplePosition;
-    float rippleSize;
-
-    //   
-    std::pair<int, int> lastHitPos;
-    bool hasLastHit;
-    std::vector<std::pair<int, int>> possibleTargets;
-    std::vector<std::pair<int, int>> directions = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
-    bool isHorizontalPossible;
-    bool isVerticalPossible;
-    bool isHuntingMode;
-    std::pair<int, int> firstHitPos;
-    std::pair<int, int> lastDirection;
-
-    //   
-    std::random_device rd;
-    std::mt19937 gen;
-
-    void addPossibleTargets(int x, int y) {
-        for (const auto& dir : directions) {
-            int nx = x + dir.first;
-            int ny = y + dir.second;
-            if (nx >= 0 && nx < GRID_SIZE && ny >= 0 && ny < GRID_SIZE) {
-                CellState cell = playerGrid.getGrid()[ny][nx];
-                if (cell == CellState::Empty || cell == CellState::Ship) {
-                    possibleTargets.emplace_back(nx, ny);
-                }
+            if (playerGrid.allShipsDestroyed()) {
+                state = GameState::ComputerWins;
+            }
+            else if (result == CellState::Miss) {
+                state = GameState::PlayerTurn;
+            }
+            else {
+                // Если компьютер попал, он продолжает ходить
+                state = GameState::ComputerTurn;
+                computerTurnClock.restart();
             }
         }
-    }
-
-    void clearPossibleTargets() {
-        possibleTargets.clear();
-        hasLastHit = false;
-        isHorizontalPossible = true;
-        isVerticalPossible = true;
-        isHuntingMode = false;
-    }
-
-    void updateDirectionInfo(int x, int y) {
-        //    
-        bool leftHit = (x > 0 && playerGrid.getGrid()[y][x - 1] == CellState::Hit);
-        bool rightHit = (x < GRID_SIZE - 1 && playerGrid.getGrid()[y][x + 1] == CellState::Hit);
-
-        //    
-        bool topHit = (y > 0 && playerGrid.getGrid()[y - 1][x] == CellState::Hit);
-        bool bottomHit = (y < GRID_SIZE - 1 && playerGrid.getGrid()[y + 1][x] == CellState::Hit);
 
-        //     ,     -  
-        if ((leftHit || rightHit) && !topHit && !bottomHit) {
-            isHorizontalPossible = true;
-            isVerticalPossible = false;
+        if (state == GameState::PlayerWins || state == GameState::ComputerWins) {
+            placementPrior.record(playerGrid);
         }
-        //     ,     -  
-        else if (!leftHit && !rightHit && (topHit || bottomHit)) {
-            isHorizontalPossible = false;
-            isVerticalPossible = true;
-        }
-    }
 
-    void startAnimation(int x, int y, bool isPlayer) {
-        animationTarget = { x, y };
-        animationProgress = 0.0f;
-        animationClock.restart();
-        isPlayerAnimation = isPlayer;
-        state = GameState::Animation;
-
-        //  ripple effect
-        rippleEffect.setRadius(1);
-        rippleEffect.setFillColor(sf::Color(255, 255, 255, 150));
-        rippleEffect.setOutlineColor(sf::Color(0, 0, 255, 200));
-        rippleEffect.setOutlineThickness(2);
-        ripplePosition = sf::Vector2f(
-            (isPlayer ? GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN : GRID_OFFSET_X) + x * CELL_SIZE + CELL_SIZE / 2,
-            GRID_OFFSET_Y + y * CELL_SIZE + CELL_SIZE / 2
-        );
-        rippleEffect.setPosition(ripplePosition);
-        rippleSize = 1;
-        showRipple = true;
+        updateShipsCount();
+        updateStatusText();
     }
 
 public:
-    Game() : state(GameState::DifficultySelection), difficulty(Difficulty::Medium),
-        currentShipSize(4), currentShipHorizontal(true), playerShipsLeft(0),
-        computerShipsLeft(0), hasLastHit(false), isHorizontalPossible(true),
-        isVerticalPossible(true), gen(rd()), animationProgress(0), showRipple(false),
-        isHuntingMode(false) {
+    // useLocalFiles = false - без ai_config.txt и статистики расстановок с диска,
+    // чтобы записанная сессия повторялась одинаково на любой машине
+    Game(uint64_t sessionSeed, const GameClock& clock, bool useLocalFiles = true) : state(GameState::DifficultySelection),
+        difficulty(Difficulty::Medium), currentShipSize(4), currentShipHorizontal(true), playerShipsLeft(0),
+        computerShipsLeft(0), particles(GameRng::forStream(sessionSeed, 0, 2)()), frameTimer(clock), computerTurnClock(clock),
+        placementPrior(useLocalFiles ? "placement_prior.dat" : ""),
+        hints(GameRng::forStream(sessionSeed, 0, 1)()), hintsEnabled(false), hintsDirty(true),
+        hudVisible(false), view(sf::FloatRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT)), viewScale(1.0f),
+        seed(sessionSeed), gamesStarted(0), gen(sessionSeed) {
         shipSizes = { 4, 3, 3, 2, 2, 2, 1, 1, 1, 1 };
-        if (!font.loadFromFile("arial.ttf")) {
-            std::cerr << "Failed to load font" << std::endl;
+        // Параметры, подобранные симулятором (необязательный файл)
+        std::ifstream config(useLocalFiles ? "ai_config.txt" : "");
+        if (config && !aiParams.loadFromFile("ai_config.txt")) {
+            std::cerr << "Failed to load AI config" << std::endl;
         }
-
-        statusText.setFont(font);
-        statusText.setCharacterSize(24);
-        statusText.setFillColor(sf::Color::Black);
-
-        playerShipsText.setFont(font);
-        playerShipsText.setCharacterSize(20);
-        playerShipsText.setFillColor(sf::Color::Black);
-        playerShipsText.setPosition(GRID_OFFSET_X, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 10);
-
-        computerShipsText.setFont(font);
-        computerShipsText.setCharacterSize(20);
-        computerShipsText.setFillColor(sf::Color::Black);
-        computerShipsText.setPosition(GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 10);
-
-        difficultyText.setFont(font);
-        difficultyText.setCharacterSize(24);
-        difficultyText.setFillColor(sf::Color::Black);
-        difficultyText.setString("Select difficulty:");
-        difficultyText.setPosition(WINDOW_WIDTH / 2 - difficultyText.getLocalBounds().width / 2, 50);
-
-        rippleEffect.setRadius(1);
-        rippleEffect.setFillColor(sf::Color::Transparent);
-        rippleEffect.setOutlineColor(sf::Color(0, 0, 255, 200));
-        rippleEffect.setOutlineThickness(2);
+        computer.setParams(aiParams);
+        computer.setPrior(&placementPrior);
     }
 
     void start() {
+        gen = GameRng::forStream(seed, gamesStarted++);
+        std::cout << "Game " << gamesStarted << ", seed " << seed << std::endl;
+
         playerGrid.clear();
         computerGrid.clear();
         placeComputerShips();
@@ -330,45 +302,79 @@ public:
         shipSizes = { 4, 3, 3, 2, 2, 2, 1, 1, 1, 1 };
         playerShipsLeft = 10;
         computerShipsLeft = 10;
-        clearPossibleTargets();
+        computer.setDifficulty(difficulty);
+        computer.reset();
+        effects.clear();
+        particles.clear();
+        hints.cancel();
+        hintsDirty = true;
         updateStatusText();
     }
 
-    void placeComputerShips() {
-        std::uniform_int_distribution<> dis(0, GRID_SIZE - 1);
-        std::uniform_int_distribution<> dir(0, 1);
-
-        for (int size : {4, 3, 3, 2, 2, 2, 1, 1, 1, 1}) {
-            bool placed = false;
-            while (!placed) {
-                int x = dis(gen);
-                int y = dis(gen);
-                bool horizontal = dir(gen) == 0;
-                placed = computerGrid.placeShip(x, y, size, horizontal);
+    // Окно изменило размер: логическое поле вписывается в окно с полосами по краям.
+    // Масштаб уходит в снимок; ресурсы под него перестраивает GameRenderer.
+    void resize(unsigned int width, unsigned int height) {
+        if (width == 0 || height == 0) return;
+        float scale = std::min(static_cast<float>(width) / WINDOW_WIDTH, static_cast<float>(height) / WINDOW_HEIGHT);
+        float viewWidth = WINDOW_WIDTH * scale / width;
+        float viewHeight = WINDOW_HEIGHT * scale / height;
+        view.setViewport(sf::FloatRect((1.0f - viewWidth) / 2, (1.0f - viewHeight) / 2, viewWidth, viewHeight));
+        viewScale = scale;
+    }
+
+    const sf::View& getView() const {
+        return view;
+    }
+
+    int gamesPlayed() const {
+        return gamesStarted;
+    }
+
+    // Отпечаток состояния (FNV-1a): экран и оба поля - для проверки повтора сессии
+    uint64_t digest() const {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](int value) {
+            hash ^= static_cast<uint64_t>(value);
+            hash *= 1099511628211ull;
+        };
+        mix(static_cast<int>(state));
+        mix(static_cast<int>(difficulty));
+        mix(gamesStarted);
+        for (const BattleGrid* grid : { &playerGrid, &computerGrid }) {
+            for (const auto& row : grid->getGrid()) {
+                for (CellState cell : row) mix(static_cast<int>(cell));
             }
         }
+        return hash;
+    }
+
+    void placeComputerShips() {
+        placeRandomFleet(computerGrid, gen);
     }
 
     void handleEvent(const sf::Event& event) {
-        if (event.type == sf::Event::MouseButtonPressed) {
+        if (event.type == sf::Event::Resized) {
+            resize(event.size.width, event.size.height);
+        }
+        else if (event.type == sf::Event::MouseButtonPressed) {
             if (event.mouseButton.button == sf::Mouse::Left) {
                 int mouseX = event.mouseButton.x;
                 int mouseY = event.mouseButton.y;
 
+                sf::Vector2f mouse(static_cast<float>(mouseX), static_cast<float>(mouseY));
+
                 if (state == GameState::DifficultySelection) {
-                    if (mouseY >= 100 && mouseY <= 140) {
-                        if (mouseX >= WINDOW_WIDTH / 2 - 100 && mouseX <= WINDOW_WIDTH / 2 - 20) {
-                            difficulty = Difficulty::Easy;
-                            start();
-                        }
-                        else if (mouseX >= WINDOW_WIDTH / 2 - 10 && mouseX <= WINDOW_WIDTH / 2 + 70) {
-                            difficulty = Difficulty::Medium;
-                            start();
-                        }
-                        else if (mouseX >= WINDOW_WIDTH / 2 + 80 && mouseX <= WINDOW_WIDTH / 2 + 180) {
-                            difficulty = Difficulty::Hard;
-                            start();
-                        }
+                    if (EASY_BUTTON.contains(mouse)) {
+                        difficulty = Difficulty::Easy;
+                        start();
+                    }
+                    else if (MEDIUM_BUTTON.contains(mouse)) {
+                        difficulty = Difficulty::Medium;
+                        start();
+                    }
+                    else if (HARD_BUTTON.contains(mouse)) {
+                        difficulty = Difficulty::Hard;
+                        start();
                     }
                 }
                 else if (state == GameState::ShipPlacement) {
@@ -388,9 +394,7 @@ public:
                             updateStatusText();
                         }
                     }
-                    else if (mouseX >= WINDOW_WIDTH / 2 - 50 && mouseX < WINDOW_WIDTH / 2 + 50 &&
-                        mouseY >= GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 20 &&
-                        mouseY < GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 60) {
+                    else if (ROTATE_BUTTON.contains(mouse)) {
                         currentShipHorizontal = !currentShipHorizontal;
                         updateStatusText();
                     }
@@ -404,7 +408,7 @@ public:
 
                         CellState cell = computerGrid.getGrid()[gridY][gridX];
                         if (cell == CellState::Empty || cell == CellState::Ship) {
-                            startAnimation(gridX, gridY, true);
+                            fireAt(gridX, gridY, true);
                         }
                     }
                 }
@@ -419,206 +423,53 @@ public:
                 (state == GameState::PlayerWins || state == GameState::ComputerWins)) {
                 state = GameState::DifficultySelection;
             }
+            else if (event.key.code == sf::Keyboard::F3) {
+                hudVisible = !hudVisible;
+            }
+            else if (event.key.code == sf::Keyboard::H) {
+                hintsEnabled = !hintsEnabled;
+                if (!hintsEnabled) {
+                    hints.cancel();
+                }
+                hintsDirty = true;
+            }
         }
     }
 
     void computerTurn() {
-        if (computerTurnClock.getElapsedTime().asMilliseconds() < 800) {
+        if (computerTurnClock.elapsedSeconds() < 0.8) {
             return;
         }
 
-        bool attacked = false;
-        while (!attacked) {
-            if (difficulty == Difficulty::Easy) {
-                //   -  
-                std::uniform_int_distribution<> dis(0, GRID_SIZE - 1);
-                int x = dis(gen);
-                int y = dis(gen);
-
-                CellState cell = playerGrid.getGrid()[y][x];
-                if (cell == CellState::Empty || cell == CellState::Ship) {
-                    startAnimation(x, y, false);
-                    attacked = true;
-                }
-            }
-            else if (difficulty == Difficulty::Medium) {
-                //   -    
-                if (hasLastHit && !possibleTargets.empty()) {
-                    //       
-                    for (auto& target : possibleTargets) {
-                        CellState cell = playerGrid.getGrid()[target.second][target.first];
-                        if (cell == CellState::Empty || cell == CellState::Ship) {
-                            startAnimation(target.first, target.second, false);
-                            attacked = true;
-                            break;
-                        }
-                    }
-
-                    //    
-                    possibleTargets.erase(
-                        std::remove_if(possibleTargets.begin(), possibleTargets.end(),
-                            [this](const std::pair<int, int>& pos) {
-                                CellState cell = playerGrid.getGrid()[pos.second][pos.first];
-                                return cell != CellState::Empty && cell != CellState::Ship;
-                            }),
-                        possibleTargets.end()
-                    );
-                }
-                else {
-                    //  ,    
-                    std::uniform_int_distribution<> dis(0, GRID_SIZE - 1);
-                    int x = dis(gen);
-                    int y = dis(gen);
-
-                    CellState cell = playerGrid.getGrid()[y][x];
-                    if (cell == CellState::Empty || cell == CellState::Ship) {
-                        startAnimation(x, y, false);
-                        attacked = true;
-                    }
-                }
-            }
-            else if (difficulty == Difficulty::Hard) {
-                //     
-                if (hasLastHit && !possibleTargets.empty()) {
-                    //       ,  
-                    std::pair<int, int> target;
-                    bool found = false;
-
-                    //      
-                    updateDirectionInfo(lastHitPos.first, lastHitPos.second);
-
-                    //      
-                    std::vector<std::pair<int, int>> filteredTargets;
-                    for (const auto& pos : possibleTargets) {
-                        if ((isHorizontalPossible && pos.second == lastHitPos.second) ||
-                            (!isHorizontalPossible && pos.first == lastHitPos.first)) {
-                            filteredTargets.push_back(pos);
-                        }
-                    }
-
-                    if (!filteredTargets.empty()) {
-                        //    
-                        std::uniform_int_distribution<> dis(0, filteredTargets.size() - 1);
-                        target = filteredTargets[dis(gen)];
-                        found = true;
-
-                        //      
-                        possibleTargets.erase(
-                            std::remove(possibleTargets.begin(), possibleTargets.end(), target),
-                            possibleTargets.end()
-                        );
-                    }
-
-                    if (!found) {
-                        //        ,    
-                        std::uniform_int_distribution<> dis(0, possibleTargets.size() - 1);
-                        target = possibleTargets[dis(gen)];
-                        possibleTargets.erase(possibleTargets.begin() + dis(gen));
-                    }
-
-                    CellState cell = playerGrid.getGrid()[target.second][target.first];
-                    if (cell == CellState::Empty || cell == CellState::Ship) {
-                        startAnimation(target.first, target.second, false);
-                        attacked = true;
-                    }
-                }
-                else {
-                    //  ,    
-                    std::uniform_int_distribution<> dis(0, GRID_SIZE - 1);
-                    int x = dis(gen);
-                    int y = dis(gen);
-
-                    CellState cell = playerGrid.getGrid()[y][x];
-                    if (cell == CellState::Empty || cell == CellState::Ship) {
-                        startAnimation(x, y, false);
-                        attacked = true;
-                    }
-                }
-            }
-        }
+        auto start = std::chrono::steady_clock::now();
+        std::pair<int, int> target = computer.chooseTarget(playerGrid, gen);
+        timings.aiSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        fireAt(target.first, target.second, false);
     }
 
-    void updateAnimation() {
-        float elapsed = animationClock.getElapsedTime().asSeconds();
-        animationProgress = std::min(elapsed / 0.5f, 1.0f); //   0.5 
-
-        //  ripple effect
-        if (showRipple) {
-            rippleSize += 20.0f;
-            rippleEffect.setRadius(rippleSize);
-            rippleEffect.setPosition(ripplePosition.x - rippleSize, ripplePosition.y - rippleSize);
+    void update() {
+        auto start = std::chrono::steady_clock::now();
+        float dt = static_cast<float>(frameTimer.elapsedSeconds());
+        frameTimer.restart();
+        effects.update(dt);
+        particles.update(dt);
 
-            float alpha = 255 * (1.0f - rippleSize / 50.0f);
-            if (alpha < 0) {
-                showRipple = false;
-            }
-            else {
-                rippleEffect.setOutlineColor(sf::Color(0, 0, 255, static_cast<sf::Uint8>(alpha)));
-            }
+        if (state == GameState::ComputerTurn) {
+            computerTurn();
         }
 
-        if (animationProgress >= 1.0f) {
-            //  
-            if (isPlayerAnimation) {
-                CellState result = computerGrid.attack(animationTarget.first, animationTarget.second);
-
-                if (computerGrid.allShipsDestroyed()) {
-                    state = GameState::PlayerWins;
-                }
-                else if (result == CellState::Miss) {
-                    state = GameState::ComputerTurn;
-                    computerTurnClock.restart();
-                }
-                else {
-                    //   ,   
-                    state = GameState::PlayerTurn;
-                }
-            }
-            else {
-                CellState result = playerGrid.attack(animationTarget.first, animationTarget.second);
-
-                if (result == CellState::Hit || result == CellState::Destroyed) {
-                    lastHitPos = animationTarget;
-                    hasLastHit = true;
-                    if (difficulty == Difficulty::Hard) {
-                        updateDirectionInfo(animationTarget.first, animationTarget.second);
-                        addPossibleTargets(animationTarget.first, animationTarget.second);
-                    }
-                    else if (difficulty == Difficulty::Medium) {
-                        addPossibleTargets(animationTarget.first, animationTarget.second);
-                    }
-                }
-
-                if (result == CellState::Destroyed) {
-                    clearPossibleTargets();
-                }
-
-                if (playerGrid.allShipsDestroyed()) {
-                    state = GameState::ComputerWins;
-                }
-                else if (result == CellState::Miss) {
-                    state = GameState::PlayerTurn;
-                }
-                else {
-                    //   ,   
-                    state = GameState::ComputerTurn;
-                    computerTurnClock.restart();
-                }
-            }
-
-            updateShipsCount();
-            updateStatusText();
-            state = (state == GameState::Animation) ? GameState::PlayerTurn : state;
+        if (hintsEnabled && hintsDirty && state == GameState::PlayerTurn) {
+            hints.request(BoardView::fromGrid(computerGrid));
+            hintsDirty = false;
         }
+        timings.updateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     }
 
-    void update() {
-        if (state == GameState::Animation) {
-            updateAnimation();
-        }
-        else if (state == GameState::ComputerTurn) {
-            computerTurn();
-        }
+    // Что-то меняется без ввода: эффекты, частицы, ход компьютера, расчет подсказки
+    // или показания панели производительности
+    bool isAnimating() {
+        return hudVisible || effects.active() || particles.active() || state == GameState::ComputerTurn ||
+            (hintsEnabled && state == GameState::PlayerTurn && (hintsDirty || hints.busy()));
     }
 
     void updateStatusText() {
@@ -630,9 +481,10 @@ public:
         case GameState::ShipPlacement:
             ss << "Place your ships (Size: " << currentShipSize << ", "
                 << (currentShipHorizontal ? "Horizontal" : "Vertical") << ")";
+            shipSizeString = "Current ship size: " + std::to_string(currentShipSize);
             break;
         case GameState::PlayerTurn:
-            ss << "Your turn - Attack enemy fleet!";
+            ss << "Your turn - Attack enemy fleet! (H - hints)";
             break;
         case GameState::ComputerTurn:
             ss << "Computer is thinking...";
@@ -643,13 +495,8 @@ public:
         case GameState::ComputerWins:
             ss << "Computer won! Press R to restart";
             break;
-        case GameState::Animation:
-            ss << (isPlayerAnimation ? "Your attack!" : "Computer attacks!");
-            break;
         }
-        statusText.setString(ss.str());
-        statusText.setPosition(WINDOW_WIDTH / 2 - statusText.getLocalBounds().width / 2,
-            GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 70);
+        statusString = ss.str();
     }
 
     void updateShipsCount() {
@@ -665,199 +512,533 @@ public:
         }
         computerShipsLeft = computerAlive;
 
-        playerShipsText.setString("Your ships: " + std::to_string(playerShipsLeft) + "/10");
-        computerShipsText.setString("Enemy ships: " + std::to_string(computerShipsLeft) + "/10");
+        playerShipsString = "Your ships: " + std::to_string(playerShipsLeft) + "/10";
+        computerShipsString = "Enemy ships: " + std::to_string(computerShipsLeft) + "/10";
     }
 
-    void draw(sf::RenderWindow& window) {
-        window.clear(sf::Color::White);
+    // Экран: выбор сложности, расстановка или бой
+    int currentScreen() const {
+        if (state == GameState::DifficultySelection) return 0;
+        if (state == GameState::ShipPlacement) return 1;
+        return 2;
+    }
 
-        if (state == GameState::DifficultySelection) {
-            window.draw(difficultyText);
+    static void copyDirtyCells(BattleGrid& grid, DirtyMask& dirty, CellState (&cells)[GRID_SIZE][GRID_SIZE]) {
+        grid.consumeDirty(dirty);
+        const auto& current = grid.getGrid();
+        dirty.forEach([&](int x, int y) {
+            cells[y][x] = current[y][x];
+        });
+    }
+
+    // Заполняет снимок для потока рисования. carry - прошлый снимок в этом буфере
+    // до рисования не дошел: его изменения остаются в масках и уходят с этим.
+    void snapshot(FrameSnapshot& out, bool carry) {
+        out.screen = currentScreen();
+        if (!carry) {
+            out.playerDirty = DirtyMask();
+            out.computerDirty = DirtyMask();
+        }
+        copyDirtyCells(playerGrid, out.playerDirty, out.playerCells);
+        copyDirtyCells(computerGrid, out.computerDirty, out.computerCells);
+        out.status = statusString;
+        out.playerShips = playerShipsString;
+        out.computerShips = computerShipsString;
+        out.shipSize = shipSizeString;
+        out.showHints = hintsEnabled && state == GameState::PlayerTurn;
+        if (out.showHints) {
+            out.hint = hints.latestResult();
+        }
+        out.sprites.clear();
+        effects.collect(out.sprites);
+        particles.collect(out.sprites);
+        out.showHud = hudVisible;
+        out.timings = timings;
+        out.view = view;
+        out.scale = viewScale;
+    }
+};
+
+// Вывод кадров по снимкам FrameSnapshot. Владеет всем, что нужно только для
+// рисования: шрифтом, атласом, сетками полей, статичным слоем и надписями.
+// Работает в потоке рисования и не трогает состояние игры.
+class GameRenderer {
+private:
+    GlyphAtlas glyphs;
+    BoardMesh playerMesh;
+    BoardMesh computerMesh;
+    SpriteBatch sprites;
+    std::vector<GlyphSprite> frameSprites;  // подсказки и эффекты кадра, память переиспользуется
+    sf::Font font;
+    PerfHud hud;
+    DrawStats stats;
+    std::chrono::steady_clock::time_point lastFrame;
+    sf::Text statusText;
+    std::string statusShown;
+    sf::Text difficultyText;
 
-            sf::RectangleShape easyButton(sf::Vector2f(80, 40));
-            easyButton.setFillColor(sf::Color(200, 200, 200));
-            easyButton.setPosition(WINDOW_WIDTH / 2 - 100, 100);
-            window.draw(easyButton);
+    // Кнопки и надписи экранов
+    Button easyButton;
+    Button mediumButton;
+    Button hardButton;
+    Button rotateButton;
+    Label playerLabel;
+    Label computerLabel;
+    Label playerShipsLabel;
+    Label computerShipsLabel;
+    Label shipSizeLabel;
+
+    // Статичный слой экрана (см. drawStaticLayer)
+    sf::RenderTexture staticLayer;
+    bool staticLayerTried;
+    bool staticLayerReady;
+    int staticLayerScreen;      // экран, нарисованный в слое; -1 - слой устарел
+
+    float scale;                // масштаб, под который построены атлас, слой и шрифты
+
+    void layoutStatus() {
+        statusText.setPosition(WINDOW_WIDTH / 2 - statusText.getGlobalBounds().width / 2,
+            GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 70);
+    }
 
-            sf::Text easyText("Easy", font, 20);
-            easyText.setFillColor(sf::Color::Black);
-            easyText.setPosition(WINDOW_WIDTH / 2 - 80, 110);
-            window.draw(easyText);
+    // Атлас, поля, статичный слой и шрифты перестраиваются только при смене
+    // масштаба окна, поэтому цена кадра от размера окна не зависит
+    void applyScale(float newScale) {
+        scale = newScale;
+        if (glyphs.setScale(scale)) {
+            playerMesh.rebuild();
+            computerMesh.rebuild();
+        }
 
-            sf::RectangleShape mediumButton(sf::Vector2f(80, 40));
-            mediumButton.setFillColor(sf::Color(200, 200, 200));
-            mediumButton.setPosition(WINDOW_WIDTH / 2 - 10, 100);
-            window.draw(mediumButton);
+        fitText(statusText, 24, scale);
+        fitText(difficultyText, 24, scale);
+        difficultyText.setPosition(WINDOW_WIDTH / 2 - difficultyText.getGlobalBounds().width / 2, 50);
+        layoutStatus();
+        for (Button* button : { &easyButton, &mediumButton, &hardButton, &rotateButton }) {
+            button->setResolution(scale);
+        }
+        for (Label* label : { &playerLabel, &computerLabel, &playerShipsLabel, &computerShipsLabel, &shipSizeLabel }) {
+            label->setResolution(scale);
+        }
+
+        staticLayerTried = false;
+        staticLayerScreen = -1;
+    }
 
-            sf::Text mediumText("Medium", font, 20);
-            mediumText.setFillColor(sf::Color::Black);
-            mediumText.setPosition(WINDOW_WIDTH / 2 - 5, 110);
-            window.draw(mediumText);
+    // Все, что не меняется, пока не сменится экран: фон, сетки, подписи полей и кнопки
+    void drawStaticContent(sf::RenderTarget& target, int screen) {
+        target.clear(sf::Color::White);
 
-            sf::RectangleShape hardButton(sf::Vector2f(100, 40));
-            hardButton.setFillColor(sf::Color(200, 200, 200));
-            hardButton.setPosition(WINDOW_WIDTH / 2 + 80, 100);
-            window.draw(hardButton);
+        if (screen == 0) {
+            target.draw(difficultyText);
+            stats.addText(difficultyText);
+            easyButton.draw(target, stats);
+            mediumButton.draw(target, stats);
+            hardButton.draw(target, stats);
+            return;
+        }
 
-            sf::Text hardText("Hard", font, 20);
-            hardText.setFillColor(sf::Color::Black);
-            hardText.setPosition(WINDOW_WIDTH / 2 + 100, 110);
-            window.draw(hardText);
+        playerMesh.drawGridLines(target, GRID_OFFSET_X, GRID_OFFSET_Y, stats);
+        computerMesh.drawGridLines(target, GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y, stats);
+        playerLabel.draw(target, stats);
+        computerLabel.draw(target, stats);
+        if (screen == 1) {
+            rotateButton.draw(target, stats);
         }
-        else {
-            drawGrid(window, GRID_OFFSET_X, GRID_OFFSET_Y, playerGrid.getGrid(), true);
-            drawGrid(window, GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y, computerGrid.getGrid(), false);
-
-            sf::Text playerLabel("Your fleet", font, 20);
-            playerLabel.setFillColor(sf::Color::Black);
-            playerLabel.setPosition(GRID_OFFSET_X, GRID_OFFSET_Y - 30);
-            window.draw(playerLabel);
-
-            sf::Text computerLabel("Enemy fleet", font, 20);
-            computerLabel.setFillColor(sf::Color::Black);
-            computerLabel.setPosition(GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y - 30);
-            window.draw(computerLabel);
-
-            window.draw(playerShipsText);
-            window.draw(computerShipsText);
-            window.draw(statusText);
-
-            //   
-            if (state == GameState::Animation && animationProgress < 1.0f) {
-                float size = CELL_SIZE * 0.8f * animationProgress;
-                sf::CircleShape explosion(size / 2);
-                explosion.setFillColor(sf::Color(255, 165, 0, 200 - static_cast<sf::Uint8>(200 * animationProgress)));
-
-                if (isPlayerAnimation) {
-                    explosion.setPosition(
-                        GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN + animationTarget.first * CELL_SIZE + (CELL_SIZE - size) / 2,
-                        GRID_OFFSET_Y + animationTarget.second * CELL_SIZE + (CELL_SIZE - size) / 2
-                    );
-                }
-                else {
-                    explosion.setPosition(
-                        GRID_OFFSET_X + animationTarget.first * CELL_SIZE + (CELL_SIZE - size) / 2,
-                        GRID_OFFSET_Y + animationTarget.second * CELL_SIZE + (CELL_SIZE - size) / 2
-                    );
-                }
-                window.draw(explosion);
-            }
+    }
 
-            //  ripple effect
-            if (showRipple && rippleSize < 50) {
-                window.draw(rippleEffect);
+    // Статичный слой рисуется в текстуру один раз на экран и выводится одним спрайтом.
+    // Текстура в настоящих пикселях окна и пересоздается только при смене масштаба.
+    // Если текстуру создать не удалось, статичное рисуется прямо в окно каждый кадр.
+    void drawStaticLayer(sf::RenderWindow& window, int screen) {
+        if (!staticLayerTried) {
+            staticLayerTried = true;
+            staticLayerReady = staticLayer.create(static_cast<unsigned int>(WINDOW_WIDTH * scale + 0.5f),
+                static_cast<unsigned int>(WINDOW_HEIGHT * scale + 0.5f));
+            if (!staticLayerReady) {
+                std::cerr << "Failed to create static layer texture" << std::endl;
             }
+            staticLayer.setView(sf::View(sf::FloatRect(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT)));
+        }
+        if (!staticLayerReady) {
+            drawStaticContent(window, screen);
+            return;
+        }
 
-            if (state == GameState::ShipPlacement) {
-                sf::Text shipSizeText("Current ship size: " + std::to_string(currentShipSize), font, 20);
-                shipSizeText.setFillColor(sf::Color::Black);
-                shipSizeText.setPosition(WINDOW_WIDTH / 2 - 100, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 100);
-                window.draw(shipSizeText);
-
-                sf::RectangleShape rotateButton(sf::Vector2f(100, 40));
-                rotateButton.setFillColor(sf::Color(200, 200, 200));
-                rotateButton.setPosition(WINDOW_WIDTH / 2 - 50, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 20);
-                window.draw(rotateButton);
-
-                sf::Text rotateText("Rotate", font, 20);
-                rotateText.setFillColor(sf::Color::Black);
-                rotateText.setPosition(WINDOW_WIDTH / 2 - 30, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 30);
-                window.draw(rotateText);
-            }
+        if (staticLayerScreen != screen) {
+            drawStaticContent(staticLayer, screen);
+            staticLayer.display();
+            staticLayerScreen = screen;
         }
+        sf::Sprite sprite(staticLayer.getTexture());
+        sprite.setScale(static_cast<float>(WINDOW_WIDTH) / staticLayer.getSize().x,
+            static_cast<float>(WINDOW_HEIGHT) / staticLayer.getSize().y);
+        window.draw(sprite);
+        stats.add(4);
     }
 
-    void drawGrid(sf::RenderWindow& window, int offsetX, int offsetY, const std::vector<std::vector<CellState>>& grid, bool showShips) {
-        for (int i = 0; i <= GRID_SIZE; ++i) {
-            sf::Vertex lineV[] = {
-                sf::Vertex(sf::Vector2f(offsetX + i * CELL_SIZE, offsetY), sf::Color::Black),
-                sf::Vertex(sf::Vector2f(offsetX + i * CELL_SIZE, offsetY + GRID_SIZE * CELL_SIZE), sf::Color::Black)
-            };
-            window.draw(lineV, 2, sf::Lines);
-
-            sf::Vertex lineH[] = {
-                sf::Vertex(sf::Vector2f(offsetX, offsetY + i * CELL_SIZE), sf::Color::Black),
-                sf::Vertex(sf::Vector2f(offsetX + GRID_SIZE * CELL_SIZE, offsetY + i * CELL_SIZE), sf::Color::Black)
-            };
-            window.draw(lineH, 2, sf::Lines);
+    // Карта вероятностей и предлагаемый выстрел картинками атласа: клетка - тонированная
+    // Empty (рамка атласа дает отступ от сетки), выстрел - зеленое кольцо.
+    // Если расчет еще не готов, ничего не добавляем.
+    void collectHints(std::vector<GlyphSprite>& out, const HintResult& result, int offsetX, int offsetY) const {
+        if (!result.valid) {
+            return;
         }
 
         for (int y = 0; y < GRID_SIZE; ++y) {
             for (int x = 0; x < GRID_SIZE; ++x) {
-                sf::RectangleShape cell(sf::Vector2f(CELL_SIZE - 2, CELL_SIZE - 2));
-                cell.setPosition(offsetX + x * CELL_SIZE + 1, offsetY + y * CELL_SIZE + 1);
-
-                switch (grid[y][x]) {
-                case CellState::Empty:
-                    cell.setFillColor(sf::Color::White);
-                    break;
-                case CellState::Ship:
-                    if (showShips) {
-                        cell.setFillColor(sf::Color(100, 100, 100));
-                    }
-                    else {
-                        cell.setFillColor(sf::Color::White);
-                    }
-                    break;
-                case CellState::Hit:
-                    cell.setFillColor(sf::Color::Red);
-                    break;
-                case CellState::Miss:
-                    cell.setFillColor(sf::Color(200, 200, 200));
-                    break;
-                case CellState::Destroyed:
-                    cell.setFillColor(sf::Color(150, 0, 0));
-                    break;
-                }
-
-                window.draw(cell);
-
-                if (grid[y][x] == CellState::Hit || grid[y][x] == CellState::Destroyed) {
-                    sf::Vertex hitX1[] = {
-                        sf::Vertex(sf::Vector2f(offsetX + x * CELL_SIZE + 5, offsetY + y * CELL_SIZE + 5), sf::Color::Black),
-                        sf::Vertex(sf::Vector2f(offsetX + (x + 1) * CELL_SIZE - 5, offsetY + (y + 1) * CELL_SIZE - 5), sf::Color::Black)
-                    };
-                    sf::Vertex hitX2[] = {
-                        sf::Vertex(sf::Vector2f(offsetX + (x + 1) * CELL_SIZE - 5, offsetY + y * CELL_SIZE + 5), sf::Color::Black),
-                        sf::Vertex(sf::Vector2f(offsetX + x * CELL_SIZE + 5, offsetY + (y + 1) * CELL_SIZE - 5), sf::Color::Black)
-                    };
-                    window.draw(hitX1, 2, sf::Lines);
-                    window.draw(hitX2, 2, sf::Lines);
-                }
-                else if (grid[y][x] == CellState::Miss) {
-                    sf::CircleShape miss(CELL_SIZE / 8);
-                    miss.setFillColor(sf::Color::Black);
-                    miss.setPosition(offsetX + x * CELL_SIZE + CELL_SIZE / 2 - CELL_SIZE / 8,
-                        offsetY + y * CELL_SIZE + CELL_SIZE / 2 - CELL_SIZE / 8);
-                    window.draw(miss);
-                }
+                if (result.heat[y][x] <= 0.0f) continue;
+                GlyphSprite cell;
+                cell.glyph = Glyph::Empty;
+                cell.rect = sf::FloatRect(static_cast<float>(offsetX + x * CELL_SIZE), static_cast<float>(offsetY + y * CELL_SIZE),
+                    static_cast<float>(CELL_SIZE), static_cast<float>(CELL_SIZE));
+                cell.color = sf::Color(255, 140, 0, static_cast<sf::Uint8>(120 * result.heat[y][x]));
+                out.push_back(cell);
             }
         }
+
+        GlyphSprite best;
+        best.glyph = Glyph::Ring;
+        best.rect = sf::FloatRect(static_cast<float>(offsetX + result.bestX * CELL_SIZE), static_cast<float>(offsetY + result.bestY * CELL_SIZE),
+            static_cast<float>(CELL_SIZE), static_cast<float>(CELL_SIZE));
+        best.color = sf::Color(0, 160, 0);
+        out.push_back(best);
+    }
+
+public:
+    GameRenderer() : glyphs(CELL_SIZE), playerMesh(glyphs, true), computerMesh(glyphs, false),
+        hud(font), lastFrame(std::chrono::steady_clock::now()),
+        staticLayerTried(false), staticLayerReady(false), staticLayerScreen(-1), scale(1.0f) {
+        frameSprites.reserve(GRID_SIZE * GRID_SIZE + 1 + EffectPool::CAPACITY + ParticleSystem::CAPACITY);
+        if (!font.loadFromFile("arial.ttf")) {
+            std::cerr << "Failed to load font" << std::endl;
+        }
+
+        statusText.setFont(font);
+        statusText.setCharacterSize(24);
+        statusText.setFillColor(sf::Color::Black);
+
+        difficultyText.setFont(font);
+        difficultyText.setCharacterSize(24);
+        difficultyText.setFillColor(sf::Color::Black);
+        difficultyText.setString("Select difficulty:");
+        difficultyText.setPosition(WINDOW_WIDTH / 2 - difficultyText.getGlobalBounds().width / 2, 50);
+
+        easyButton.setup(font, EASY_BUTTON, "Easy", sf::Vector2f(20, 10));
+        mediumButton.setup(font, MEDIUM_BUTTON, "Medium", sf::Vector2f(5, 10));
+        hardButton.setup(font, HARD_BUTTON, "Hard", sf::Vector2f(20, 10));
+        rotateButton.setup(font, ROTATE_BUTTON, "Rotate", sf::Vector2f(20, 10));
+        playerLabel.setup(font, 20, sf::Vector2f(GRID_OFFSET_X, GRID_OFFSET_Y - 30), "Your fleet");
+        computerLabel.setup(font, 20, sf::Vector2f(GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y - 30), "Enemy fleet");
+        playerShipsLabel.setup(font, 20, sf::Vector2f(GRID_OFFSET_X, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 10), "");
+        computerShipsLabel.setup(font, 20,
+            sf::Vector2f(GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 10), "");
+        shipSizeLabel.setup(font, 20, sf::Vector2f(WINDOW_WIDTH / 2 - 100, GRID_OFFSET_Y + GRID_SIZE * CELL_SIZE + 100), "");
+    }
+
+    // Кадр по снимку; время рисования, вызовы draw и вершины идут в панель производительности
+    void draw(sf::RenderWindow& window, const FrameSnapshot& frame) {
+        auto start = std::chrono::steady_clock::now();
+        stats.reset();
+        drawFrame(window, frame);
+        if (frame.showHud) {
+            hud.draw(window, stats, frame.timings);
+        }
+        auto end = std::chrono::steady_clock::now();
+        hud.recordFrame(std::chrono::duration<double>(end - start).count(),
+            std::chrono::duration<double>(start - lastFrame).count());
+        lastFrame = start;
+    }
+
+private:
+    void drawFrame(sf::RenderWindow& window, const FrameSnapshot& frame) {
+        if (frame.scale != scale) {
+            applyScale(frame.scale);
+        }
+        // Маски изменений применяются в каждом снимке, даже если поля не видны:
+        // следующий снимок несет только новые изменения
+        playerMesh.update(frame.playerCells, frame.playerDirty);
+        computerMesh.update(frame.computerCells, frame.computerDirty);
+
+        window.clear(sf::Color::White);
+        window.setView(frame.view);
+        drawStaticLayer(window, frame.screen);
+        if (frame.screen == 0) {
+            return;
+        }
+
+        // Поле целиком - один вызов draw с текстурой атласа
+        playerMesh.draw(window, glyphs.getTexture(), GRID_OFFSET_X, GRID_OFFSET_Y, stats);
+        computerMesh.draw(window, glyphs.getTexture(), GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y, stats);
+
+        playerShipsLabel.setString(frame.playerShips);
+        computerShipsLabel.setString(frame.computerShips);
+        playerShipsLabel.draw(window, stats);
+        computerShipsLabel.draw(window, stats);
+        if (frame.status != statusShown) {
+            statusShown = frame.status;
+            statusText.setString(statusShown);
+            layoutStatus();
+        }
+        window.draw(statusText);
+        stats.addText(statusText);
+
+        // Подсказки, эффекты и частицы - один вызов draw с текстурой атласа;
+        // подсказки идут первыми и остаются под эффектами
+        frameSprites.clear();
+        if (frame.showHints) {
+            collectHints(frameSprites, frame.hint, GRID_OFFSET_X + GRID_SIZE * CELL_SIZE + MARGIN, GRID_OFFSET_Y);
+        }
+        frameSprites.insert(frameSprites.end(), frame.sprites.begin(), frame.sprites.end());
+        sprites.draw(window, glyphs, frameSprites, stats);
+
+        if (frame.screen == 1) {
+            shipSizeLabel.setString(frame.shipSize);
+            shipSizeLabel.draw(window, stats);
+        }
     }
 };
 
-int main() {
+// Координаты мыши в пикселях окна переводятся в логические координаты игры
+static void toLogical(const sf::RenderWindow& window, const sf::View& view, int& x, int& y) {
+    sf::Vector2f point = window.mapPixelToCoords(sf::Vector2i(x, y), view);
+    x = static_cast<int>(std::floor(point.x));
+    y = static_cast<int>(std::floor(point.y));
+}
+
+static double percentileOf(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static void printCost(const char* name, const std::vector<double>& seconds) {
+    double total = 0.0;
+    for (double s : seconds) total += s;
+    std::cout << name << ": " << seconds.size() << " calls, mean "
+        << (seconds.empty() ? 0.0 : 1e6 * total / seconds.size()) << " us, p99 "
+        << 1e6 * percentileOf(seconds, 0.99) << " us, max " << 1e6 * percentileOf(seconds, 1.0) << " us" << std::endl;
+}
+
+// Повтор записанных сессий без окна на виртуальных часах. Замеряется время
+// handleEvent и update; итог каждой сессии сверяется с записанным.
+// Возвращает число сессий, которые не удалось повторить.
+static int replaySessions(const std::vector<std::string>& files) {
+    std::vector<double> eventSeconds, updateSeconds;
+    int failed = 0;
+
+    for (const auto& file : files) {
+        SessionRecording session;
+        if (!loadSession(file, session)) {
+            std::cerr << "Failed to load session " << file << std::endl;
+            failed++;
+            continue;
+        }
+
+        VirtualClock clock;
+        Game game(session.seed, clock, false);
+        for (const auto& e : session.events) {
+            clock.setTime(e.time);
+            sf::Event event;
+            bool isEvent = toSfEvent(e, event);
+            auto start = std::chrono::steady_clock::now();
+            if (isEvent) game.handleEvent(event);
+            else game.update();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            (isEvent ? eventSeconds : updateSeconds).push_back(seconds);
+        }
+
+        if (!session.finished) {
+            std::cerr << file << ": no recorded outcome" << std::endl;
+            failed++;
+        }
+        else if (session.games != game.gamesPlayed() || session.digest != game.digest()) {
+            std::cerr << file << ": diverged from the recording" << std::endl;
+            failed++;
+        }
+    }
+
+    std::cout << "Replayed " << files.size() << " session(s), " << failed << " failed" << std::endl;
+    printCost("handleEvent", eventSeconds);
+    printCost("update", updateSeconds);
+    return failed;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: Project1 [options]\n"
+        << "  --seed N           repeat the computer's decisions from an earlier session\n"
+        << "  --turbo K          speed up pauses and animations K times\n"
+        << "  --record FILE      record input to FILE\n"
+        << "  --replay FILE      replay a recording without a window (may repeat)\n";
+}
+
+int main(int argc, char* argv[]) {
+    // --seed N повторяет решения компьютера из прошлой сессии,
+    // --turbo K ускоряет паузы и анимации в K раз,
+    // --record FILE записывает ввод, --replay FILE (можно несколько) повторяет записи без окна
+    uint64_t seed = 0;
+    bool hasSeed = false;
+    double turbo = 1.0;
+    std::string recordFile;
+    std::vector<std::string> replayFiles;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) {
+            std::istringstream value(argv[++i]);
+            hasSeed = static_cast<bool>(value >> seed);
+            if (!hasSeed) {
+                std::cerr << "Invalid seed: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--turbo" && hasValue) {
+            std::istringstream value(argv[++i]);
+            if (!(value >> turbo) || turbo <= 0.0) {
+                std::cerr << "Invalid turbo factor: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--record" && hasValue) {
+            recordFile = argv[++i];
+        }
+        else if (arg == "--replay" && hasValue) {
+            replayFiles.push_back(argv[++i]);
+        }
+        else {
+            // Опечатка в параметрах не должна молча запускать обычную игру
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (!replayFiles.empty()) {
+        return replaySessions(replayFiles) == 0 ? 0 : 1;
+    }
+    if (!hasSeed) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    SessionRecorder recorder;
+    if (!recordFile.empty() && !recorder.open(recordFile, seed)) {
+        std::cerr << "Failed to open session recording" << std::endl;
+    }
+
     sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "Sea Battle");
     window.setFramerateLimit(60);
 
-    Game game;
+    // Время кадра фиксируется в начале кадра: все чтения часов внутри кадра
+    // видят одно значение, и запись повторяется точно
+    ScaledClock clock(turbo);
+    VirtualClock frameClock;
+    Game game(seed, frameClock, !recorder.isOpen());
+
+    // Рисование идет в своем потоке по снимкам, которые публикует игра. Снимки
+    // передаются через тройной буфер без блокировок: медленный кадр не задерживает
+    // логику и ИИ, а долгий ход ИИ не останавливает вывод.
+    TripleBuffer<FrameSnapshot> frames;
+    frames.forEach([](FrameSnapshot& frame) {
+        frame.sprites.reserve(EffectPool::CAPACITY + ParticleSystem::CAPACITY);
+    });
+    // Данные идут через буфер без блокировок; мьютекс и условная переменная
+    // нужны только чтобы поток рисования спал, пока новых снимков нет
+    std::mutex frameMutex;
+    std::condition_variable frameReady;
+    bool rendering = true;
+    window.setActive(false);
+    std::thread renderThread([&]() {
+        window.setActive(true);
+        GameRenderer renderer;
+        while (true) {
+            if (!frames.fetch()) {
+                std::unique_lock<std::mutex> lock(frameMutex);
+                frameReady.wait(lock, [&]() { return !rendering || frames.pending(); });
+                if (!rendering) break;
+                continue;
+            }
+            renderer.draw(window, frames.readBuffer());
+            window.display();
+        }
+        window.setActive(false);
+    });
+    // Будит поток рисования; пустой захват мьютекса не дает пробуждению
+    // проскочить между проверкой условия и началом ожидания
+    auto wakeRenderer = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(frameMutex);
+        }
+        frameReady.notify_one();
+    };
+
+    // Снимки публикуются, пока что-то меняется само; в остальное время цикл спит
+    // в waitEvent и публикует снимок только после ввода
+    bool open = true;
+    bool redraw = true;
+    bool dropped = false;       // буфер писателя держит снимок, не дошедший до рисования
+    // Мышь записывается и обрабатывается в логических координатах,
+    // поэтому запись повторяется при любом размере окна
+    auto process = [&](sf::Event event) {
+        if (event.type == sf::Event::Closed) {
+            open = false;
+        }
+        else if (event.type == sf::Event::MouseButtonPressed || event.type == sf::Event::MouseButtonReleased) {
+            toLogical(window, game.getView(), event.mouseButton.x, event.mouseButton.y);
+        }
+        else if (event.type == sf::Event::MouseMoved) {
+            toLogical(window, game.getView(), event.mouseMove.x, event.mouseMove.y);
+        }
+        recorder.event(event, frameClock.now());
+        game.handleEvent(event);
+        if (event.type != sf::Event::MouseMoved) {
+            redraw = true;
+        }
+    };
 
-    while (window.isOpen()) {
+    // Логика идет с частотой 60 шагов в секунду независимо от рисования
+    const std::chrono::microseconds tick(16667);
+    auto nextTick = std::chrono::steady_clock::now();
+    while (open) {
         sf::Event event;
+        bool waited = !redraw && !game.isAnimating() && window.waitEvent(event);
+        frameClock.setTime(clock.now());
+        if (waited) {
+            process(event);
+        }
         while (window.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                window.close();
-            }
-            game.handleEvent(event);
+            process(event);
         }
 
+        bool animating = game.isAnimating();
+        recorder.update(frameClock.now());
         game.update();
 
-        window.clear();
-        game.draw(window);
-        window.display();
+        if (redraw || animating || game.isAnimating()) {
+            game.snapshot(frames.writeBuffer(), dropped);
+            dropped = frames.publish();
+            wakeRenderer();
+            redraw = false;
+        }
+
+        nextTick += tick;
+        auto now = std::chrono::steady_clock::now();
+        if (nextTick < now) {
+            nextTick = now;
+        }
+        else {
+            std::this_thread::sleep_until(nextTick);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        rendering = false;
     }
+    frameReady.notify_one();
+    renderThread.join();
+    window.close();
 
+    recorder.finish(game.gamesPlayed(), game.digest());
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+
+// Передача значений от одного потока-писателя одному читателю без блокировок.
+// Писатель заполняет свой буфер и публикует его, читатель забирает последний
+// опубликованный. Промежуточные значения пропускаются, никто никого не ждет.
+template <class T>
+class TripleBuffer {
+private:
+    static const int FRESH = 4;
+
+    T buffers[3];
+    std::atomic<int> latest;    // последний опубликованный буфер; FRESH - читатель его еще не забрал
+    int back;                   // буфер писателя
+    int front;                  // буфер читателя
+
+public:
+    TripleBuffer() : latest(0), back(1), front(2) {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Начальная настройка всех буферов, до запуска потоков
+    template <class F>
+    void forEach(F setup) {
+        for (T& buffer : buffers) setup(buffer);
+    }
+
+    // Буфер писателя; в нем остались данные одной из прошлых публикаций
+    T& writeBuffer() {
+        return buffers[back];
+    }
+
+    // Возвращает true, если прошлое опубликованное значение читатель так и не
+    // забрал: оно вернулось писателю буфером и пропало для читателя
+    bool publish() {
+        int previous = latest.exchange(back | FRESH, std::memory_order_acq_rel);
+        back = previous & 3;
+        return (previous & FRESH) != 0;
+    }
+
+    // Есть ли опубликованное значение, которое читатель еще не забрал
+    bool pending() const {
+        return (latest.load(std::memory_order_acquire) & FRESH) != 0;
+    }
+
+    // Забирает последнее опубликованное значение; false - нового нет
+    bool fetch() {
+        if (!(latest.load(std::memory_order_acquire) & FRESH)) return false;
+        front = latest.exchange(front, std::memory_order_acq_rel) & 3;
+        return true;
+    }
+
+    T& readBuffer() {
+        return buffers[front];
+    }
+};
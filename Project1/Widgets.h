@@ -0,0 +1,76 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <algorithm>
+
+#include "DrawStats.h"
+
+// Текст размера logicalSize в логических пикселях, растеризованный для масштаба
+// окна scale: шрифт строится в настоящих пикселях и уменьшается обратно
+inline void fitText(sf::Text& text, unsigned int logicalSize, float scale) {
+    unsigned int pixels = std::max(1u, static_cast<unsigned int>(logicalSize * scale + 0.5f));
+    text.setCharacterSize(pixels);
+    float factor = static_cast<float>(logicalSize) / pixels;
+    text.setScale(factor, factor);
+}
+
+// Надпись создается один раз; раскладка текста пересчитывается только при смене строки
+class Label {
+private:
+    sf::Text text;
+    std::string content;
+    unsigned int logicalSize = 0;
+
+public:
+    void setup(const sf::Font& font, unsigned int size, sf::Vector2f position, const std::string& value) {
+        text.setFont(font);
+        logicalSize = size;
+        text.setCharacterSize(size);
+        text.setFillColor(sf::Color::Black);
+        text.setPosition(position);
+        setString(value);
+    }
+
+    void setString(const std::string& value) {
+        if (value == content) return;
+        content = value;
+        text.setString(value);
+    }
+
+    void setResolution(float scale) {
+        fitText(text, logicalSize, scale);
+    }
+
+    void draw(sf::RenderTarget& target, DrawStats& stats) const {
+        target.draw(text);
+        stats.addText(text);
+    }
+};
+
+// Кнопка: прямоугольник и надпись. Прямоугольник задается общими константами
+// раскладки (EASY_BUTTON и др.), по ним же игра проверяет нажатия, поэтому
+// рисунок и область нажатия не расходятся.
+class Button {
+private:
+    sf::RectangleShape shape;
+    Label caption;
+
+public:
+    // captionOffset - положение надписи относительно левого верхнего угла
+    void setup(const sf::Font& font, sf::FloatRect rect, const std::string& text, sf::Vector2f captionOffset) {
+        shape.setSize(sf::Vector2f(rect.width, rect.height));
+        shape.setPosition(rect.left, rect.top);
+        shape.setFillColor(sf::Color(200, 200, 200));
+        caption.setup(font, 20, sf::Vector2f(rect.left, rect.top) + captionOffset, text);
+    }
+
+    void setResolution(float scale) {
+        caption.setResolution(scale);
+    }
+
+    void draw(sf::RenderTarget& target, DrawStats& stats) const {
+        target.draw(shape);
+        stats.addShape(shape);
+        caption.draw(target, stats);
+    }
+};
@@ -0,0 +1,129 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <chrono>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+
+#include "BatchSim.h"
+#include "ShotStats.h"
+#include "SelfPlay.h"
+
+// Пакетный движок (BatchSim.h): K партий одним шагом. Экспериментальный: стратегия
+// у него своя - карта плотности без весов и добивание, со своим генератором, -
+// и ни один режим самоигры (simulate, tune, tournament, sweep) его не использует.
+// Цифры описывают сам движок, а не ИИ игры (для него - simulate --difficulty hard).
+// Для сравнения скорости рядом замеряется обычный цикл сложного уровня.
+
+struct BatchSettings {
+    long long games = 100000;
+    int lanes = 32;                 // 8, 16 или 32
+    uint64_t seed = 1;
+    int checkBatches = 4;           // пакеты для сверки с BattleGrid перед замером, 0 - без сверки
+    int compareGames = 2000;        // партии обычного цикла сложного уровня для сравнения, 0 - без сравнения
+};
+
+// Сверка с BattleGrid: расстановка каждой дорожки переносится на BattleGrid,
+// каждый выстрел повторяется на нем, результаты и все клетки должны совпасть.
+// Возвращает пустую строку или описание первого расхождения.
+template <int K>
+std::string checkBatchAgainstGrid(uint32_t seed, int batches) {
+    std::unique_ptr<BatchBattle<K>> battle(new BatchBattle<K>(seed));
+    BatchBattle<K>& b = *battle;
+    for (int batch = 0; batch < batches; ++batch) {
+        b.placeFleets();
+        std::vector<BattleGrid> grids(K);
+        for (int l = 0; l < K; ++l) {
+            if (!b.exportFleet(l, grids[l])) {
+                std::ostringstream error;
+                error << "batch " << batch << ", lane " << l << ": fleet breaks BattleGrid placement rules";
+                return error.str();
+            }
+        }
+
+        int x[K], y[K];
+        bool active[K];
+        CellState result[K];
+        for (int shot = 0; !b.allFinished(); ++shot) {
+            b.step(x, y, active, result);
+            for (int l = 0; l < K; ++l) {
+                if (!active[l]) continue;
+                CellState expected = grids[l].attack(x[l], y[l]);
+                bool same = expected == result[l];
+                for (int cy = 0; cy < GRID_SIZE && same; ++cy) {
+                    for (int cx = 0; cx < GRID_SIZE && same; ++cx) {
+                        same = grids[l].getGrid()[cy][cx] == b.cellState(l, cx, cy);
+                    }
+                }
+                if (!same || b.finished(l) != grids[l].allShipsDestroyed()) {
+                    std::ostringstream error;
+                    error << "batch " << batch << ", lane " << l << ", shot " << shot
+                        << " at (" << x[l] << ", " << y[l] << "): differs from BattleGrid";
+                    return error.str();
+                }
+            }
+        }
+    }
+    return "";
+}
+
+template <int K>
+int runBatchLanes(const BatchSettings& settings) {
+    uint32_t seed = static_cast<uint32_t>(settings.seed ^ (settings.seed >> 32));
+    if (settings.checkBatches > 0) {
+        std::string error = checkBatchAgainstGrid<K>(seed ^ 0x5EEDu, settings.checkBatches);
+        if (!error.empty()) {
+            std::cerr << "Batch engine self-check failed: " << error << std::endl;
+            return 1;
+        }
+        std::cout << "Self-check: " << settings.checkBatches * K << " games match BattleGrid shot by shot" << std::endl;
+    }
+
+    std::vector<int> shots;
+    shots.reserve(static_cast<size_t>(settings.games));
+    auto start = std::chrono::steady_clock::now();
+    runBatchGames<K>(static_cast<int>(settings.games), seed, shots);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ShotStats stats;
+    for (int s : shots) stats.add(s);
+    double rate = stats.games / seconds;
+    std::cout << "Batch engine, " << K << " lanes, " << stats.games << " games (unweighted density strategy)\n"
+        << std::fixed << std::setprecision(2) << "shots to win: mean " << stats.mean()
+        << ", p50 " << stats.percentile(0.5) << ", p90 " << stats.percentile(0.9)
+        << ", p99 " << stats.percentile(0.99) << ", max " << stats.percentile(1.0) << "\n"
+        << std::setprecision(0) << rate << " games/s\n"
+        << "Note: strategy and RNG differ from the game's Hard AI, so shot counts are not comparable;"
+        << " for the game AI use simulate --difficulty hard" << std::endl;
+
+    // Обычный цикл: одна партия сложного уровня за раз, один поток
+    if (settings.compareGames > 0) {
+        AiParams params;
+        long long total = 0;
+        start = std::chrono::steady_clock::now();
+        for (int g = 0; g < settings.compareGames; ++g) {
+            total += playSelfPlayGame(params, Difficulty::Hard, settings.seed, static_cast<uint32_t>(g));
+        }
+        double scalarRate = settings.compareGames / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Scalar hard loop: " << scalarRate << " games/s (mean " << std::setprecision(2)
+            << static_cast<double>(total) / settings.compareGames << "), batch speedup "
+            << rate / scalarRate << "x" << std::endl;
+    }
+    return 0;
+}
+
+inline int runBatch(const BatchSettings& settings) {
+    switch (settings.lanes) {
+    case 8:
+        return runBatchLanes<8>(settings);
+    case 16:
+        return runBatchLanes<16>(settings);
+    case 32:
+        return runBatchLanes<32>(settings);
+    default:
+        std::cerr << "Lanes must be 8, 16 or 32" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,303 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+
+#include "BattleGrid.h"
+#include "ComputerPlayer.h"
+
+// Микробенчмарки движка правил и решений ИИ
+
+struct BenchResult {
+    std::string name;
+    double nsPerOp;
+    long long ops;
+};
+
+struct BenchSettings {
+    std::string outputFile = "bench.json";
+    std::string baselineFile;       // пусто - без сравнения
+    // Допустимое замедление, %. Лучший раунд из нескольких проходов держит
+    // разброс на выделенной машине в пределах нескольких процентов, но на общей
+    // (виртуальной) отдельные операции по 50 нс уходят на 20% и больше - там
+    // порог поднимают или увеличивают --passes.
+    double threshold = 25.0;
+    double minSeconds = 0.1;        // минимальное время замеров на бенчмарк за проход
+    int passes = 3;                 // проходы по всем бенчмаркам, берется лучший
+    std::string filter;             // подстрока имени
+    uint64_t seed = 1;
+};
+
+// Результаты операций складываются сюда, чтобы компилятор их не выбросил
+static volatile int benchSink = 0;
+
+// Раунд: prepare(i) готовит данные для batch операций вне замера, затем
+// одним замером идут все batch вызовов op(i). Шаблон, а не std::function:
+// косвенный вызов внутри замера стоил бы больше самых быстрых операций.
+// Итог - лучший раунд: помехи (переключения потоков, частота процессора)
+// только добавляют время, поэтому минимум стабильнее медианы между запусками.
+template <typename Prepare, typename Op>
+BenchResult measure(const std::string& name, int batch, double minSeconds, Prepare&& prepare, Op&& op) {
+    const int minRounds = 5;
+    const int maxRounds = 200;
+    std::vector<double> rounds;
+    double measured = 0.0;
+    long long ops = 0;
+
+    while (static_cast<int>(rounds.size()) < maxRounds &&
+        (static_cast<int>(rounds.size()) < minRounds || measured < minSeconds)) {
+        for (int i = 0; i < batch; ++i) prepare(i);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < batch; ++i) op(i);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        rounds.push_back(seconds * 1e9 / batch);
+        measured += seconds;
+        ops += batch;
+    }
+
+    BenchResult result = { name, *std::min_element(rounds.begin(), rounds.end()), ops };
+    return result;
+}
+
+// Позиции середины партии, в которых у ИИ нет недобитых кораблей
+inline std::vector<BattleGrid> huntPositions(GameRng& gen, int count) {
+    std::vector<BattleGrid> positions;
+    while (static_cast<int>(positions.size()) < count) {
+        BattleGrid grid;
+        placeRandomFleet(grid, gen);
+        ComputerPlayer computer;
+        computer.setDifficulty(Difficulty::Hard);
+        computer.reset();
+
+        int shots = 0;
+        bool wounded = false;
+        while (!grid.allShipsDestroyed() && static_cast<int>(positions.size()) < count) {
+            if (!wounded && shots >= 10 && shots % 5 == 0) positions.push_back(grid);
+            std::pair<int, int> target = computer.chooseTarget(grid, gen);
+            CellState result = grid.attack(target.first, target.second);
+            computer.onAttackResult(grid, target.first, target.second, result);
+            if (result == CellState::Hit) wounded = true;
+            if (result == CellState::Destroyed) wounded = false;
+            shots++;
+        }
+    }
+    return positions;
+}
+
+inline std::vector<BenchResult> runBenchmarks(const BenchSettings& settings) {
+    const int batch = 1000;
+    GameRng gen(settings.seed);
+    std::vector<BenchResult> results;
+
+    auto enabled = [&](const std::string& name) {
+        return settings.filter.empty() || name.find(settings.filter) != std::string::npos;
+    };
+    // Бенчмарк замеряется в каждом проходе, остается лучший результат:
+    // проходы разнесены во времени, и долгий период помех портит только один из них
+    auto add = [&](const std::string& name, auto prepare, auto op) {
+        if (!enabled(name)) return;
+        BenchResult r = measure(name, batch, settings.minSeconds, prepare, op);
+        auto known = std::find_if(results.begin(), results.end(),
+            [&name](const BenchResult& b) { return b.name == name; });
+        if (known == results.end()) {
+            results.push_back(r);
+            return;
+        }
+        known->nsPerOp = std::min(known->nsPerOp, r.nsPerOp);
+        known->ops += r.ops;
+    };
+    auto noPrepare = [](int) {};
+
+    // Исходные поля: полный флот и списки клеток разного типа
+    BattleGrid fleet;
+    placeRandomFleet(fleet, gen);
+    std::vector<std::pair<int, int>> emptyCells, hitCells, sinkCells;
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            if (fleet.getGrid()[y][x] == CellState::Empty) emptyCells.emplace_back(x, y);
+        }
+    }
+    for (const auto& ship : fleet.getShips()) {
+        if (ship.size == 1) sinkCells.push_back(ship.positions.front());
+        else hitCells.push_back(ship.positions.front());
+    }
+
+    struct Placement { int x, y, size; bool horizontal; };
+    std::vector<Placement> placements;
+    for (int size = 1; size <= MAX_SHIP_SIZE; ++size) {
+        for (int h = 0; h < 2; ++h) {
+            for (int y = 0; y < GRID_SIZE; ++y) {
+                for (int x = 0; x < GRID_SIZE; ++x) {
+                    placements.push_back({ x, y, size, h == 0 });
+                }
+            }
+        }
+    }
+
+    std::vector<BattleGrid> grids(batch);
+    const BattleGrid empty;
+    std::vector<Placement> fitting;
+    for (const auto& p : placements) {
+        if (empty.canPlaceShip(p.x, p.y, p.size, p.horizontal)) fitting.push_back(p);
+    }
+
+    // Худший случай: потоплены все корабли, кроме последнего
+    BattleGrid almostDone = fleet;
+    for (size_t s = 0; s < almostDone.getShips().size(); ++s) {
+        const Ship ship = almostDone.getShips()[s];
+        size_t cells = s + 1 == almostDone.getShips().size() ? ship.positions.size() - 1 : ship.positions.size();
+        for (size_t c = 0; c < cells; ++c) {
+            almostDone.attack(ship.positions[c].first, ship.positions[c].second);
+        }
+    }
+
+    // Позиции поиска для решений ИИ (без недобитых кораблей)
+    std::vector<BattleGrid> positions = huntPositions(gen, 64);
+    const Difficulty levels[] = { Difficulty::Easy, Difficulty::Medium, Difficulty::Hard };
+
+    for (int pass = 0; pass < std::max(1, settings.passes); ++pass) {
+        add("grid.canPlaceShip", noPrepare, [&](int i) {
+            const Placement& p = placements[i % placements.size()];
+            benchSink += fleet.canPlaceShip(p.x, p.y, p.size, p.horizontal);
+        });
+
+        // Корабль ставится на пустое поле, чтобы каждая попытка была успешной
+        add("grid.placeShip", [&](int i) { grids[i] = empty; }, [&](int i) {
+            const Placement& p = fitting[i % fitting.size()];
+            benchSink += grids[i].placeShip(p.x, p.y, p.size, p.horizontal);
+        });
+
+        add("grid.attack.miss", [&](int i) { grids[i] = fleet; }, [&](int i) {
+            const auto& cell = emptyCells[i % emptyCells.size()];
+            benchSink += static_cast<int>(grids[i].attack(cell.first, cell.second));
+        });
+
+        add("grid.attack.hit", [&](int i) { grids[i] = fleet; }, [&](int i) {
+            const auto& cell = hitCells[i % hitCells.size()];
+            benchSink += static_cast<int>(grids[i].attack(cell.first, cell.second));
+        });
+
+        add("grid.attack.sink", [&](int i) { grids[i] = fleet; }, [&](int i) {
+            const auto& cell = sinkCells[i % sinkCells.size()];
+            benchSink += static_cast<int>(grids[i].attack(cell.first, cell.second));
+        });
+
+        add("grid.markAroundDestroyedShip", [&](int i) { grids[i] = fleet; }, [&](int i) {
+            const auto& ships = grids[i].getShips();
+            grids[i].markAroundDestroyedShip(ships[i % ships.size()]);
+        });
+
+        add("grid.allShipsDestroyed", noPrepare, [&](int) {
+            benchSink += almostDone.allShipsDestroyed();
+        });
+
+        add("placeComputerShips", [&](int i) { grids[i] = empty; }, [&](int i) {
+            placeRandomFleet(grids[i], gen);
+        });
+
+        // Одно решение ИИ в позиции поиска
+        for (int level = 0; level < 3; ++level) {
+            ComputerPlayer computer;
+            computer.setDifficulty(levels[level]);
+            computer.reset();
+            add(std::string("computerTurn.") + difficultyName(levels[level]), noPrepare, [&](int i) {
+                std::pair<int, int> target = computer.chooseTarget(positions[i % positions.size()], gen);
+                benchSink += target.first + target.second;
+            });
+        }
+    }
+
+    for (const auto& r : results) {
+        std::cout << std::left << std::setw(34) << r.name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(1) << r.nsPerOp << " ns/op" << std::endl;
+    }
+    return results;
+}
+
+inline bool writeBenchJson(const std::string& fileName, const std::vector<BenchResult>& results, uint64_t seed) {
+    std::ofstream out(fileName);
+    if (!out) return false;
+    out << "{\n  \"seed\": " << seed << ",\n  \"benchmarks\": [\n";
+    out << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < results.size(); ++i) {
+        out << "    { \"name\": \"" << results[i].name << "\", \"ns_per_op\": " << results[i].nsPerOp
+            << ", \"ops\": " << results[i].ops << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+// Читает файл, записанный writeBenchJson: пары name / ns_per_op
+inline bool readBenchJson(const std::string& fileName, std::vector<BenchResult>& results) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    const std::string nameKey = "\"name\": \"";
+    const std::string timeKey = "\"ns_per_op\": ";
+    size_t pos = 0;
+    while ((pos = text.find(nameKey, pos)) != std::string::npos) {
+        pos += nameKey.size();
+        size_t end = text.find('"', pos);
+        size_t time = text.find(timeKey, end);
+        if (end == std::string::npos || time == std::string::npos) return false;
+
+        BenchResult r = { text.substr(pos, end - pos), std::atof(text.c_str() + time + timeKey.size()), 0 };
+        results.push_back(r);
+        pos = time;
+    }
+    return true;
+}
+
+inline int runBench(const BenchSettings& settings) {
+    std::vector<BenchResult> results = runBenchmarks(settings);
+
+    if (!writeBenchJson(settings.outputFile, results, settings.seed)) {
+        std::cerr << "Failed to save benchmark results" << std::endl;
+        return 1;
+    }
+    std::cout << "Saved " << settings.outputFile << std::endl;
+
+    if (settings.baselineFile.empty()) return 0;
+
+    std::vector<BenchResult> baseline;
+    if (!readBenchJson(settings.baselineFile, baseline)) {
+        std::cerr << "Failed to load benchmark baseline" << std::endl;
+        return 1;
+    }
+
+    int regressions = 0;
+    std::cout << "\nCompared with " << settings.baselineFile << " (threshold " << settings.threshold << "%)\n";
+    for (const auto& r : results) {
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+            [&r](const BenchResult& b) { return b.name == r.name; });
+        std::cout << std::left << std::setw(34) << r.name << std::right;
+        if (base == baseline.end() || base->nsPerOp <= 0.0) {
+            std::cout << "  new\n";
+            continue;
+        }
+
+        double change = 100.0 * (r.nsPerOp - base->nsPerOp) / base->nsPerOp;
+        bool regressed = change > settings.threshold;
+        if (regressed) regressions++;
+        std::cout << std::setw(12) << std::setprecision(1) << base->nsPerOp << " -> "
+            << std::setw(10) << r.nsPerOp << std::showpos << std::setw(9) << change << "%" << std::noshowpos
+            << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+
+    if (regressions) {
+        std::cerr << regressions << " benchmark(s) regressed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <functional>
+#include <cstdio>
+
+#include "ShotStats.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+// Общее для контрольных точек долгих прогонов. Состояние генераторов не
+// сохраняется: каждая партия берет свои потоки из (seed, номер партии), поэтому
+// достаточно знать, какие партии уже сыграны, и накопленные итоги.
+
+// Пишем во временный файл и подменяем, чтобы прерванная запись не испортила точку
+inline bool writeFileAtomically(const std::string& fileName, const std::function<void(std::ostream&)>& write) {
+    std::string tmp = fileName + ".tmp";
+    {
+        std::ofstream out(tmp);
+        if (!out) return false;
+        out.precision(17);
+        write(out);
+        if (!out) return false;
+    }
+    // Замена одним вызовом: старый файл не удаляется заранее, так что при сбое
+    // на диске остается либо прежняя точка, либо новая
+#ifdef _WIN32
+    return MoveFileExA(tmp.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(tmp.c_str(), fileName.c_str()) == 0;
+#endif
+}
+
+// Гистограмма пишется только непустыми столбцами
+inline void writeShotStats(std::ostream& out, const ShotStats& stats) {
+    int bins = 0;
+    for (long long count : stats.histogram) {
+        if (count) bins++;
+    }
+    out << stats.games << " " << stats.totalShots << " " << stats.firstSideWins << " " << bins;
+    for (int i = 0; i <= ShotStats::MAX_SHOTS; ++i) {
+        if (stats.histogram[i]) out << " " << i << " " << stats.histogram[i];
+    }
+    out << "\n";
+}
+
+inline bool readShotStats(std::istream& in, ShotStats& stats) {
+    ShotStats loaded;
+    int bins = 0;
+    in >> loaded.games >> loaded.totalShots >> loaded.firstSideWins >> bins;
+    for (int b = 0; b < bins && in; ++b) {
+        int shots = -1;
+        long long count = 0;
+        in >> shots >> count;
+        if (shots < 0 || shots > ShotStats::MAX_SHOTS) return false;
+        loaded.histogram[shots] = count;
+    }
+    if (!in) return false;
+    stats = loaded;
+    return true;
+}
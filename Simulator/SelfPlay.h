@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <chrono>
+
+#include "BattleGrid.h"
+#include "ComputerPlayer.h"
+
+// Номера потоков случайных чисел внутри одной партии
+const uint32_t STREAM_FLEET = 0;
+const uint32_t STREAM_AI = 1;
+const uint32_t STREAM_TUNER = 2;        // возмущения тюнера; index - номер итерации
+const uint32_t STREAM_SECOND_FLEET = 3;
+const uint32_t STREAM_SECOND_AI = 4;
+
+// Независимые потоки случайных чисел для партии index из серии seed.
+// Расстановка флота и решения ИИ берутся из разных потоков: кандидаты с разными
+// параметрами получают одинаковые расстановки (общие случайные числа).
+inline GameRng selfPlayStream(uint64_t seed, uint32_t index, uint32_t stream) {
+    return GameRng::forStream(seed, index, stream);
+}
+
+// ИИ стреляет по случайной расстановке до победы, результат - число выстрелов.
+// moveSeconds, если задан, получает время каждого решения ИИ.
+inline int playSelfPlayGame(const AiParams& params, Difficulty difficulty, uint64_t seed, uint32_t index,
+    std::vector<double>* moveSeconds = nullptr) {
+    GameRng fleetGen = selfPlayStream(seed, index, STREAM_FLEET);
+    GameRng aiGen = selfPlayStream(seed, index, STREAM_AI);
+
+    BattleGrid grid;
+    placeRandomFleet(grid, fleetGen);
+
+    ComputerPlayer computer;
+    computer.setDifficulty(difficulty);
+    computer.setParams(params);
+    computer.reset();
+
+    int shots = 0;
+    while (!grid.allShipsDestroyed() && shots < GRID_SIZE * GRID_SIZE) {
+        std::chrono::steady_clock::time_point start;
+        if (moveSeconds) start = std::chrono::steady_clock::now();
+        std::pair<int, int> target = computer.chooseTarget(grid, aiGen);
+        if (moveSeconds) {
+            moveSeconds->push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        CellState result = grid.attack(target.first, target.second);
+        computer.onAttackResult(grid, target.first, target.second, result);
+        shots++;
+    }
+    return shots;
+}
+
+struct MatchSide {
+    AiParams params;
+    Difficulty difficulty;
+};
+
+struct MatchResult {
+    int winner;     // 0 или 1
+    int shots[2];   // выстрелы каждой стороны
+};
+
+// Партия ИИ против ИИ по правилам игры: попавший стреляет еще раз.
+// В четных партиях начинает сторона 0, в нечетных - сторона 1.
+inline MatchResult playAiMatch(const MatchSide& first, const MatchSide& second, uint64_t seed, uint32_t index) {
+    GameRng fleetGen[2] = { selfPlayStream(seed, index, STREAM_FLEET), selfPlayStream(seed, index, STREAM_SECOND_FLEET) };
+    GameRng aiGen[2] = { selfPlayStream(seed, index, STREAM_AI), selfPlayStream(seed, index, STREAM_SECOND_AI) };
+    const MatchSide* sides[2] = { &first, &second };
+
+    BattleGrid grids[2];    // grids[i] - флот стороны i
+    ComputerPlayer computers[2];
+    for (int i = 0; i < 2; ++i) {
+        placeRandomFleet(grids[i], fleetGen[i]);
+        computers[i].setDifficulty(sides[i]->difficulty);
+        computers[i].setParams(sides[i]->params);
+        computers[i].reset();
+    }
+
+    MatchResult result = { -1, { 0, 0 } };
+    int turn = index & 1;
+    while (result.winner < 0) {
+        BattleGrid& target = grids[1 - turn];
+        std::pair<int, int> shot = computers[turn].chooseTarget(target, aiGen[turn]);
+        CellState cell = target.attack(shot.first, shot.second);
+        computers[turn].onAttackResult(target, shot.first, shot.second, cell);
+        result.shots[turn]++;
+
+        if (target.allShipsDestroyed() || result.shots[turn] >= GRID_SIZE * GRID_SIZE) {
+            result.winner = turn;
+        }
+        else if (cell == CellState::Miss) {
+            turn = 1 - turn;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,218 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <new>
+
+#include "ShotStats.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+// Зеркальные партии в отдельных процессах. Каждый процесс получает свой
+// непрерывный диапазон задач (блоков партий) и отдает результат каждой задачи
+// через кольцо в общей памяти. Если процесс упал, непринятые задачи его
+// диапазона отдаются новому процессу. Гистограммы сливаются точно, поэтому
+// итог совпадает с потоковым режимом.
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "shared memory ring needs lock-free atomics");
+
+// Результат одной задачи
+struct ShardRecord {
+    uint32_t task;
+    uint32_t games;
+    uint32_t firstSideWins;
+    uint64_t totalShots;
+    uint32_t histogram[ShotStats::MAX_SHOTS + 1];
+};
+
+// Кольцо одного процесса: пишет только процесс, читает только координатор
+struct ShardRing {
+    static const uint32_t SIZE = 64;
+    std::atomic<uint32_t> head;     // записано процессом
+    std::atomic<uint32_t> tail;     // принято координатором
+    ShardRecord slots[SIZE];
+};
+
+inline void pushShardRecord(ShardRing& ring, uint32_t task, const ShotStats& stats) {
+    uint32_t head = ring.head.load(std::memory_order_relaxed);
+    while (head - ring.tail.load(std::memory_order_acquire) == ShardRing::SIZE) {
+        std::this_thread::yield();
+    }
+
+    ShardRecord& record = ring.slots[head % ShardRing::SIZE];
+    record.task = task;
+    record.games = static_cast<uint32_t>(stats.games);
+    record.firstSideWins = static_cast<uint32_t>(stats.firstSideWins);
+    record.totalShots = static_cast<uint64_t>(stats.totalShots);
+    for (int i = 0; i <= ShotStats::MAX_SHOTS; ++i) {
+        record.histogram[i] = static_cast<uint32_t>(stats.histogram[i]);
+    }
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+// Забирает готовые записи; nextTask - первая задача, результат которой еще не принят
+inline bool drainShardRing(ShardRing& ring, ShotStats& total, int& nextTask) {
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    uint32_t head = ring.head.load(std::memory_order_acquire);
+    if (tail == head) return false;
+
+    for (; tail != head; ++tail) {
+        const ShardRecord& record = ring.slots[tail % ShardRing::SIZE];
+        total.games += record.games;
+        total.totalShots += record.totalShots;
+        total.firstSideWins += record.firstSideWins;
+        for (int i = 0; i <= ShotStats::MAX_SHOTS; ++i) {
+            total.histogram[i] += record.histogram[i];
+        }
+        nextTask = static_cast<int>(record.task) + 1;
+    }
+    ring.tail.store(tail, std::memory_order_release);
+    return true;
+}
+
+struct ShardSettings {
+    int processes = 1;
+    bool pin = false;               // закрепить процесс k за ядром k
+    int maxRestarts = 3;            // на один диапазон
+};
+
+struct ShardReport {
+    int restarts = 0;
+};
+
+#ifndef _WIN32
+
+inline void pinToCore(int index) {
+#ifdef __linux__
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores <= 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+// Партии first..last-1; задача t - партии first + t * chunk и дальше
+inline bool simulateMirrorProcesses(Difficulty difficulty, long long first, long long last, int chunk, uint64_t seed,
+    const ShardSettings& settings, ShotStats& total, ShardReport& report) {
+    struct Worker {
+        pid_t pid = 0;
+        int nextTask = 0;
+        int endTask = 0;
+        int restarts = 0;
+    };
+
+    int tasks = static_cast<int>((last - first + chunk - 1) / chunk);
+    int processes = std::max(1, std::min(settings.processes, tasks));
+    size_t bytes = sizeof(ShardRing) * processes;
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Failed to allocate shared memory" << std::endl;
+        return false;
+    }
+    ShardRing* rings = static_cast<ShardRing*>(memory);
+    for (int p = 0; p < processes; ++p) {
+        new (&rings[p]) ShardRing();
+    }
+
+    std::vector<Worker> workers(processes);
+    for (int p = 0; p < processes; ++p) {
+        workers[p].nextTask = static_cast<int>(static_cast<long long>(tasks) * p / processes);
+        workers[p].endTask = static_cast<int>(static_cast<long long>(tasks) * (p + 1) / processes);
+    }
+    MatchSide side = { AiParams(), difficulty };
+
+    auto spawn = [&](int slot) {
+        Worker& worker = workers[slot];
+        rings[slot].head.store(0);
+        rings[slot].tail.store(0);
+        std::cout.flush();
+        std::cerr.flush();
+
+        pid_t pid = fork();
+        if (pid < 0) return false;
+        if (pid == 0) {
+            if (settings.pin) pinToCore(slot);
+            for (int task = worker.nextTask; task < worker.endTask; ++task) {
+                ShotStats stats;
+                long long begin = first + static_cast<long long>(task) * chunk;
+                playMirrorRange(side, seed, begin, std::min(last, begin + chunk), stats);
+                pushShardRecord(rings[slot], static_cast<uint32_t>(task), stats);
+            }
+            _exit(0);
+        }
+        worker.pid = pid;
+        return true;
+    };
+
+    total = ShotStats();
+    bool ok = true;
+    int running = 0;
+    for (int p = 0; p < processes && ok; ++p) {
+        ok = spawn(p);
+        if (ok) running++;
+    }
+    if (!ok) std::cerr << "Failed to start worker process" << std::endl;
+
+    while (running > 0) {
+        bool busy = false;
+        for (int p = 0; p < processes; ++p) {
+            if (workers[p].pid > 0 && drainShardRing(rings[p], total, workers[p].nextTask)) busy = true;
+        }
+
+        int status = 0;
+        pid_t finished = waitpid(-1, &status, WNOHANG);
+        if (finished > 0) {
+            busy = true;
+            auto it = std::find_if(workers.begin(), workers.end(),
+                [finished](const Worker& w) { return w.pid == finished; });
+            if (it == workers.end()) continue;
+            int slot = static_cast<int>(it - workers.begin());
+            Worker& worker = *it;
+            drainShardRing(rings[slot], total, worker.nextTask);
+            worker.pid = 0;
+            running--;
+            if (worker.nextTask >= worker.endTask) continue;
+
+            // Процесс завершился раньше времени: его оставшиеся задачи - новому процессу
+            std::cerr << "Worker " << slot << " failed ("
+                << (WIFSIGNALED(status) ? "signal " : "exit code ")
+                << (WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status))
+                << "), re-queuing tasks " << worker.nextTask << "-" << worker.endTask - 1 << std::endl;
+            if (!ok || worker.restarts >= settings.maxRestarts || !spawn(slot)) {
+                ok = false;
+                continue;
+            }
+            worker.restarts++;
+            report.restarts++;
+            running++;
+        }
+        if (!busy) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+
+    munmap(memory, bytes);
+    if (!ok) std::cerr << "Worker processes failed" << std::endl;
+    return ok;
+}
+
+#else
+
+inline bool simulateMirrorProcesses(Difficulty, long long, long long, int, uint64_t, const ShardSettings&, ShotStats&, ShardReport&) {
+    std::cerr << "Worker processes are not supported on this platform, use --threads" << std::endl;
+    return false;
+}
+
+#endif
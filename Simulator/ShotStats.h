@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+
+#include "SelfPlay.h"
+
+// Распределение числа выстрелов до победы. Гистограмма точная (выстрелов не
+// больше числа клеток), поэтому слияние результатов потоков не зависит от порядка.
+struct ShotStats {
+    static const int MAX_SHOTS = GRID_SIZE * GRID_SIZE;
+
+    long long games = 0;
+    long long totalShots = 0;
+    long long firstSideWins = 0;
+    std::vector<long long> histogram;
+
+    ShotStats() : histogram(MAX_SHOTS + 1, 0) {
+    }
+
+    void add(int shots) {
+        games++;
+        totalShots += shots;
+        histogram[shots]++;
+    }
+
+    void merge(const ShotStats& other) {
+        games += other.games;
+        totalShots += other.totalShots;
+        firstSideWins += other.firstSideWins;
+        for (int i = 0; i <= MAX_SHOTS; ++i) {
+            histogram[i] += other.histogram[i];
+        }
+    }
+
+    double mean() const {
+        return games ? static_cast<double>(totalShots) / games : 0.0;
+    }
+
+    // Наименьшее число выстрелов, которого хватило в доле p партий
+    int percentile(double p) const {
+        long long need = static_cast<long long>(p * games + 0.999999);
+        if (need < 1) need = 1;
+        long long seen = 0;
+        for (int i = 0; i <= MAX_SHOTS; ++i) {
+            seen += histogram[i];
+            if (seen >= need) return i;
+        }
+        return MAX_SHOTS;
+    }
+};
+
+// Зеркальные партии begin..end-1; учитываются выстрелы победителя
+inline void playMirrorRange(const MatchSide& side, uint64_t seed, long long begin, long long end, ShotStats& stats) {
+    for (long long g = begin; g < end; ++g) {
+        MatchResult result = playAiMatch(side, side, seed, static_cast<uint32_t>(g));
+        stats.add(result.shots[result.winner]);
+        if (result.winner == static_cast<int>(g & 1)) stats.firstSideWins++;
+    }
+}
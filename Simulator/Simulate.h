@@ -0,0 +1,204 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <cstdint>
+#include <memory>
+
+#include "SelfPlay.h"
+#include "ShotStats.h"
+#include "TaskPool.h"
+#include "Shards.h"
+#include "Checkpoint.h"
+
+struct SimulationSettings {
+    long long games = 100000;        // на каждый уровень сложности
+    int threads = 0;                // 0 - по числу ядер
+    uint64_t seed = 1;
+    std::vector<Difficulty> difficulties = { Difficulty::Easy, Difficulty::Medium, Difficulty::Hard };
+    bool scaling = false;
+    int chunk = 1000;               // партий в одной задаче пула
+    int processes = 0;              // 0 - потоки в одном процессе
+    bool pin = false;               // закрепить процессы за ядрами
+    std::string checkpointFile;     // пусто - без контрольных точек
+    int checkpointBlocks = 50;      // задач между контрольными точками
+    bool resume = false;
+};
+
+inline int defaultThreadCount() {
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    return threads > 0 ? threads : 1;
+}
+
+// Зеркальные партии first..last-1 уровня difficulty против самого себя; учитываются выстрелы победителя
+inline ShotStats simulateMirror(Difficulty difficulty, long long first, long long last, int chunk, uint64_t seed,
+    WorkStealingPool& pool) {
+    int tasks = static_cast<int>((last - first + chunk - 1) / chunk);
+    std::vector<ShotStats> perTask(tasks);
+    MatchSide side = { AiParams(), difficulty };
+
+    pool.run(tasks, [&](int, int task) {
+        long long begin = first + static_cast<long long>(task) * chunk;
+        long long end = std::min(last, begin + chunk);
+        playMirrorRange(side, seed, begin, end, perTask[task]);
+    });
+
+    ShotStats total;
+    for (const auto& stats : perTask) total.merge(stats);
+    return total;
+}
+
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Сыгранные партии и итоги по каждому уровню из settings.difficulties
+struct SimulationProgress {
+    std::vector<long long> played;
+    std::vector<ShotStats> stats;
+};
+
+inline bool saveSimulationCheckpoint(const std::string& fileName, const SimulationSettings& settings,
+    const SimulationProgress& progress) {
+    return writeFileAtomically(fileName, [&](std::ostream& out) {
+        out << "SeaBattleSimulate 1\n" << settings.seed << " " << settings.games << " "
+            << settings.difficulties.size() << "\n";
+        for (size_t d = 0; d < settings.difficulties.size(); ++d) {
+            out << difficultyName(settings.difficulties[d]) << " " << progress.played[d] << "\n";
+            writeShotStats(out, progress.stats[d]);
+        }
+    });
+}
+
+// Точка подходит, только если она от прогона с теми же сидом, числом партий и уровнями
+inline bool loadSimulationCheckpoint(const std::string& fileName, const SimulationSettings& settings,
+    SimulationProgress& progress) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    std::string magic;
+    int version = 0;
+    uint64_t seed = 0;
+    long long games = 0;
+    size_t count = 0;
+    in >> magic >> version >> seed >> games >> count;
+    if (!in || magic != "SeaBattleSimulate" || version != 1) return false;
+    if (seed != settings.seed || games != settings.games || count != settings.difficulties.size()) return false;
+
+    SimulationProgress loaded = progress;
+    for (size_t d = 0; d < count; ++d) {
+        std::string name;
+        in >> name >> loaded.played[d];
+        if (!in || name != difficultyName(settings.difficulties[d])) return false;
+        if (!readShotStats(in, loaded.stats[d]) || loaded.stats[d].games != loaded.played[d]) return false;
+    }
+    progress = loaded;
+    return true;
+}
+
+inline int runSimulation(const SimulationSettings& settings) {
+    bool useProcesses = settings.processes > 0;
+    int threads = settings.threads > 0 ? settings.threads : defaultThreadCount();
+    int workers = useProcesses ? settings.processes : threads;
+    const char* workerName = useProcesses ? "processes" : "threads";
+    ShardReport report;
+
+    // Партии уровня на workers потоках или процессах; итог одинаков в обоих режимах.
+    // Пул потоков живет между вызовами и пересоздается только при смене их числа.
+    std::unique_ptr<WorkStealingPool> pool;
+    auto play = [&](Difficulty difficulty, long long first, long long last, int count, ShotStats& stats) {
+        if (!useProcesses) {
+            if (!pool || pool->threads() != count) pool.reset(new WorkStealingPool(count));
+            stats = simulateMirror(difficulty, first, last, settings.chunk, settings.seed, *pool);
+            return true;
+        }
+        ShardSettings shards;
+        shards.processes = count;
+        shards.pin = settings.pin;
+        return simulateMirrorProcesses(difficulty, first, last, settings.chunk, settings.seed, shards, stats, report);
+    };
+
+    SimulationProgress progress;
+    progress.played.assign(settings.difficulties.size(), 0);
+    progress.stats.resize(settings.difficulties.size());
+    bool checkpoints = !settings.checkpointFile.empty();
+    if (checkpoints && settings.resume) {
+        if (!loadSimulationCheckpoint(settings.checkpointFile, settings, progress)) {
+            std::cerr << "Failed to load simulation checkpoint" << std::endl;
+            return 1;
+        }
+        std::cout << "Resumed from " << settings.checkpointFile << std::endl;
+    }
+    // С контрольными точками партии идут отрезками, после каждого точка перезаписывается
+    long long segment = checkpoints ? static_cast<long long>(settings.chunk) * settings.checkpointBlocks : settings.games;
+
+    std::cout << (useProcesses ? "Processes: " : "Threads: ") << workers << ", games per difficulty: " << settings.games
+        << ", seed: " << settings.seed << "\n\n";
+    std::cout << std::left << std::setw(8) << "level" << std::right
+        << std::setw(10) << "games" << std::setw(12) << "games/s"
+        << std::setw(8) << "mean" << std::setw(6) << "p50" << std::setw(6) << "p90"
+        << std::setw(6) << "p99" << std::setw(6) << "max" << std::setw(10) << "starter" << "\n";
+
+    std::cout << std::fixed;
+    for (size_t d = 0; d < settings.difficulties.size(); ++d) {
+        Difficulty difficulty = settings.difficulties[d];
+        ShotStats& stats = progress.stats[d];
+        long long& played = progress.played[d];
+        long long resumedAt = played;
+
+        auto start = std::chrono::steady_clock::now();
+        while (played < settings.games) {
+            long long end = std::min(settings.games, played + segment);
+            ShotStats part;
+            if (!play(difficulty, played, end, workers, part)) return 1;
+            stats.merge(part);
+            played = end;
+            if (checkpoints && !saveSimulationCheckpoint(settings.checkpointFile, settings, progress)) {
+                std::cerr << "Failed to save simulation checkpoint" << std::endl;
+            }
+        }
+        double seconds = secondsSince(start);
+
+        std::cout << std::left << std::setw(8) << difficultyName(difficulty) << std::right
+            << std::setw(10) << stats.games
+            << std::setw(12) << std::setprecision(0) << (played > resumedAt ? (played - resumedAt) / seconds : 0.0)
+            << std::setw(8) << std::setprecision(2) << stats.mean()
+            << std::setw(6) << stats.percentile(0.5) << std::setw(6) << stats.percentile(0.9)
+            << std::setw(6) << stats.percentile(0.99) << std::setw(6) << stats.percentile(1.0)
+            << std::setw(9) << std::setprecision(1) << 100.0 * stats.firstSideWins / stats.games << "%\n";
+    }
+
+    if (settings.scaling) {
+        // Одинаковая нагрузка (все уровни) на 1, 2, 4 ... потоках или процессах
+        long long games = std::min<long long>(settings.games, 20000);
+        std::cout << "\nScaling (" << games << " games per level)\n";
+        std::cout << std::setw(9) << workerName << std::setw(11) << "games/s"
+            << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << "\n";
+
+        double baseRate = 0.0;
+        for (int t = 1; ; t = std::min(t * 2, workers)) {
+            auto start = std::chrono::steady_clock::now();
+            long long played = 0;
+            for (Difficulty difficulty : settings.difficulties) {
+                ShotStats stats;
+                if (!play(difficulty, 0, games, t, stats)) return 1;
+                played += stats.games;
+            }
+            double rate = played / secondsSince(start);
+            if (t == 1) baseRate = rate;
+
+            std::cout << std::setw(9) << t << std::setw(11) << std::setprecision(0) << rate
+                << std::setw(9) << std::setprecision(2) << rate / baseRate << "x"
+                << std::setw(11) << std::setprecision(0) << 100.0 * rate / baseRate / t << "%\n";
+            if (t == workers) break;
+        }
+    }
+    if (report.restarts) {
+        std::cout << "\nRestarted worker processes: " << report.restarts << std::endl;
+    }
+    return 0;
+}
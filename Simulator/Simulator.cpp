@@ -0,0 +1,386 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <sstream>
+
+#include "Tuner.h"
+#include "Simulate.h"
+#include "Bench.h"
+#include "Tournament.h"
+#include "Sweep.h"
+#include "Batch.h"
+
+// Консольные инструменты для ИИ: Simulator <команда> [параметры]
+
+static bool parseDifficulty(const std::string& name, Difficulty& difficulty) {
+    if (name == "easy") difficulty = Difficulty::Easy;
+    else if (name == "medium") difficulty = Difficulty::Medium;
+    else if (name == "hard") difficulty = Difficulty::Hard;
+    else return false;
+    return true;
+}
+
+static void printUsage() {
+    std::cout << "Usage: Simulator <command> [options]\n"
+        << "\n"
+        << "simulate             AI-vs-AI games, shots-to-win statistics per difficulty\n"
+        << "  --games N          games per difficulty (default 100000)\n"
+        << "  --threads N        worker threads (default: all cores)\n"
+        << "  --seed N           master seed (default 1)\n"
+        << "  --difficulty D     easy, medium, hard or all (default all)\n"
+        << "  --processes N      play in N worker processes instead of threads\n"
+        << "  --pin              pin worker process k to core k\n"
+        << "  --scaling          also measure throughput on 1, 2, 4 ... threads or processes\n"
+        << "  --checkpoint FILE  save progress to FILE every 50 blocks of games\n"
+        << "  --resume           continue from the checkpoint\n"
+        << "\n"
+        << "bench                micro-benchmarks of the rules engine and AI decisions\n"
+        << "  --out FILE         JSON results (default bench.json)\n"
+        << "  --baseline FILE    compare with earlier results, exit code 1 on regression\n"
+        << "  --threshold PCT    allowed slowdown in percent (default 25)\n"
+        << "  --time SECONDS     minimum measuring time per benchmark and pass (default 0.1)\n"
+        << "  --passes N         passes over all benchmarks, the best one counts (default 3)\n"
+        << "  --filter TEXT      only benchmarks whose name contains TEXT\n"
+        << "  --seed N           seed for positions and fleets (default 1)\n"
+        << "\n"
+        << "batch                experimental batch engine: K games per step in bitboards\n"
+        << "                     (its own strategy, not the game AI; not used by the other commands)\n"
+        << "  --games N          games (default 100000)\n"
+        << "  --lanes K          games per step: 8, 16 or 32 (default 32)\n"
+        << "  --seed N           master seed (default 1)\n"
+        << "  --check N          batches replayed on BattleGrid before measuring, 0 - none (default 4)\n"
+        << "  --compare N        scalar hard games timed for comparison, 0 - none (default 2000)\n"
+        << "\n"
+        << "tournament           round robin between all registered strategies\n"
+        << "  --games N          maximum games per pairing (default 10000)\n"
+        << "  --block N          games between early stop checks (default 200)\n"
+        << "  --no-early-stop    always play the maximum number of games\n"
+        << "  --threads N        worker threads (default: all cores)\n"
+        << "  --seed N           master seed (default 1)\n"
+        << "  --config FILE      add a hard-tuned strategy with these AI parameters\n"
+        << "  --csv FILE         write results as CSV\n"
+        << "  --json FILE        write results as JSON\n"
+        << "  --checkpoint FILE  save progress to FILE after every block\n"
+        << "  --resume           continue from the checkpoint\n"
+        << "\n"
+        << "sweep                strength of time-budgeted strategies per move budget\n"
+        << "  --budgets LIST     comma separated budgets in ms (default 0.01,0.1,1,10)\n"
+        << "  --games N          games per budget (default 200)\n"
+        << "  --against NAME     opponent for the win rate (default hard)\n"
+        << "  --threads N        worker threads (default: all cores)\n"
+        << "  --seed N           master seed (default 1)\n"
+        << "  --csv FILE         write results as CSV\n"
+        << "  --json FILE        write results as JSON\n"
+        << "\n"
+        << "tune                 self-play tuning of the AI parameters\n"
+        << "  --iterations N     SPSA iterations (default 200)\n"
+        << "  --games N          games per evaluation (default 2000)\n"
+        << "  --threads N        worker threads (default: all cores)\n"
+        << "  --seed N           master seed (default 1)\n"
+        << "  --difficulty D     easy, medium or hard (default hard)\n"
+        << "  --checkpoint FILE  checkpoint file (default tune_checkpoint.txt)\n"
+        << "  --out FILE         config for the game (default ai_config.txt)\n"
+        << "  --resume           continue from the checkpoint\n";
+}
+
+static int runSimulate(int argc, char* argv[]) {
+    SimulationSettings settings;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scaling") {
+            settings.scaling = true;
+        }
+        else if (arg == "--pin") {
+            settings.pin = true;
+        }
+        else if (arg == "--resume") {
+            settings.resume = true;
+        }
+        else if (arg == "--checkpoint" && hasValue) {
+            settings.checkpointFile = argv[++i];
+        }
+        else if (arg == "--processes" && hasValue) {
+            settings.processes = std::atoi(argv[++i]);
+        }
+        else if (arg == "--games" && hasValue) {
+            settings.games = std::atoll(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            settings.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--difficulty" && hasValue) {
+            std::string name = argv[++i];
+            Difficulty difficulty;
+            if (name != "all") {
+                if (!parseDifficulty(name, difficulty)) {
+                    std::cerr << "Unknown difficulty: " << name << std::endl;
+                    return 1;
+                }
+                settings.difficulties = { difficulty };
+            }
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.games <= 0) {
+        std::cerr << "Number of games must be positive" << std::endl;
+        return 1;
+    }
+    if (settings.resume && settings.checkpointFile.empty()) {
+        std::cerr << "--resume needs --checkpoint" << std::endl;
+        return 1;
+    }
+    return runSimulation(settings);
+}
+
+static int runBenchCommand(int argc, char* argv[]) {
+    BenchSettings settings;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--out" && hasValue) {
+            settings.outputFile = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            settings.baselineFile = argv[++i];
+        }
+        else if (arg == "--threshold" && hasValue) {
+            settings.threshold = std::atof(argv[++i]);
+        }
+        else if (arg == "--time" && hasValue) {
+            settings.minSeconds = std::atof(argv[++i]);
+        }
+        else if (arg == "--passes" && hasValue) {
+            settings.passes = std::atoi(argv[++i]);
+        }
+        else if (arg == "--filter" && hasValue) {
+            settings.filter = argv[++i];
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    return runBench(settings);
+}
+
+static int runBatchCommand(int argc, char* argv[]) {
+    BatchSettings settings;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) {
+            settings.games = std::atoll(argv[++i]);
+        }
+        else if (arg == "--lanes" && hasValue) {
+            settings.lanes = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--check" && hasValue) {
+            settings.checkBatches = std::atoi(argv[++i]);
+        }
+        else if (arg == "--compare" && hasValue) {
+            settings.compareGames = std::atoi(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.games <= 0) {
+        std::cerr << "Number of games must be positive" << std::endl;
+        return 1;
+    }
+    return runBatch(settings);
+}
+
+static int runTournamentCommand(int argc, char* argv[]) {
+    TournamentSettings settings;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--no-early-stop") {
+            settings.earlyStop = false;
+        }
+        else if (arg == "--resume") {
+            settings.resume = true;
+        }
+        else if (arg == "--checkpoint" && hasValue) {
+            settings.checkpointFile = argv[++i];
+        }
+        else if (arg == "--games" && hasValue) {
+            settings.maxGames = std::atoll(argv[++i]);
+        }
+        else if (arg == "--block" && hasValue) {
+            settings.block = std::atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            settings.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--config" && hasValue) {
+            settings.tunedConfig = argv[++i];
+        }
+        else if (arg == "--csv" && hasValue) {
+            settings.csvFile = argv[++i];
+        }
+        else if (arg == "--json" && hasValue) {
+            settings.jsonFile = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.maxGames <= 0 || settings.block <= 0) {
+        std::cerr << "Number of games must be positive" << std::endl;
+        return 1;
+    }
+    if (settings.resume && settings.checkpointFile.empty()) {
+        std::cerr << "--resume needs --checkpoint" << std::endl;
+        return 1;
+    }
+    return runTournament(settings);
+}
+
+static int runSweepCommand(int argc, char* argv[]) {
+    SweepSettings settings;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--budgets" && hasValue) {
+            settings.budgetsMs.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                double budget = std::atof(item.c_str());
+                if (budget <= 0.0) {
+                    std::cerr << "Budget must be positive: " << item << std::endl;
+                    return 1;
+                }
+                settings.budgetsMs.push_back(budget);
+            }
+        }
+        else if (arg == "--games" && hasValue) {
+            settings.games = std::atoll(argv[++i]);
+        }
+        else if (arg == "--against" && hasValue) {
+            settings.reference = argv[++i];
+        }
+        else if (arg == "--threads" && hasValue) {
+            settings.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--csv" && hasValue) {
+            settings.csvFile = argv[++i];
+        }
+        else if (arg == "--json" && hasValue) {
+            settings.jsonFile = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.games <= 0 || settings.budgetsMs.empty()) {
+        std::cerr << "Number of games and budgets must be positive" << std::endl;
+        return 1;
+    }
+    return runSweep(settings);
+}
+
+static int runTune(int argc, char* argv[]) {
+    TunerSettings settings;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--resume") {
+            settings.resume = true;
+        }
+        else if (arg == "--iterations" && hasValue) {
+            settings.iterations = std::atoi(argv[++i]);
+        }
+        else if (arg == "--games" && hasValue) {
+            settings.gamesPerEval = std::atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            settings.threads = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            settings.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--difficulty" && hasValue) {
+            if (!parseDifficulty(argv[++i], settings.difficulty)) {
+                std::cerr << "Unknown difficulty: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--checkpoint" && hasValue) {
+            settings.checkpointFile = argv[++i];
+        }
+        else if (arg == "--out" && hasValue) {
+            settings.outputFile = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.gamesPerEval <= 0) {
+        std::cerr << "Games per evaluation must be positive" << std::endl;
+        return 1;
+    }
+    return runTuner(settings);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if (command == "simulate") {
+        return runSimulate(argc, argv);
+    }
+    if (command == "bench") {
+        return runBenchCommand(argc, argv);
+    }
+    if (command == "batch") {
+        return runBatchCommand(argc, argv);
+    }
+    if (command == "tournament") {
+        return runTournamentCommand(argc, argv);
+    }
+    if (command == "sweep") {
+        return runSweepCommand(argc, argv);
+    }
+    if (command == "tune") {
+        return runTune(argc, argv);
+    }
+
+    std::cerr << "Unknown command: " << command << std::endl;
+    printUsage();
+    return 1;
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+#include "SelfPlay.h"
+#include "Simulate.h"
+#include "Tournament.h"
+#include "TaskPool.h"
+
+// Качество стратегий с бюджетом времени на ход в зависимости от бюджета
+
+struct SweepSettings {
+    std::vector<double> budgetsMs = { 0.01, 0.1, 1.0, 10.0 };
+    long long games = 200;          // на каждую точку
+    int threads = 0;
+    uint64_t seed = 1;
+    std::string reference = "hard"; // соперник для доли побед
+    std::string csvFile;
+    std::string jsonFile;
+};
+
+struct SweepPoint {
+    std::string strategy;
+    double budgetMs = 0.0;
+    ShotStats shots;                // партии в одиночку: выстрелов до победы
+    double meanMoveMs = 0.0;
+    double p99MoveMs = 0.0;
+    long long wins = 0;             // партии против соперника
+    long long matches = 0;
+};
+
+inline bool isTimeBudgeted(const Strategy& strategy) {
+    const AiParams& p = strategy.side.params;
+    return strategy.side.difficulty == Difficulty::Hard && (p.sampleBudget > 0.0f || p.timeBudgetMs > 0.0f);
+}
+
+inline SweepPoint measureBudget(const Strategy& strategy, const MatchSide& reference, double budgetMs,
+    const SweepSettings& settings, WorkStealingPool& pool) {
+    SweepPoint point;
+    point.strategy = strategy.name;
+    point.budgetMs = budgetMs;
+
+    // Бюджет задается только временем
+    MatchSide side = strategy.side;
+    side.params.sampleBudget = 0.0f;
+    side.params.timeBudgetMs = static_cast<float>(budgetMs);
+
+    struct Part {
+        ShotStats shots;
+        std::vector<double> moves;
+        long long wins = 0;
+    };
+    const int chunk = 4;
+    int tasks = static_cast<int>((settings.games + chunk - 1) / chunk);
+    std::vector<Part> parts(tasks);
+
+    pool.run(tasks, [&](int, int task) {
+        Part& part = parts[task];
+        long long end = std::min(settings.games, static_cast<long long>(task + 1) * chunk);
+        for (long long g = static_cast<long long>(task) * chunk; g < end; ++g) {
+            uint32_t index = static_cast<uint32_t>(g);
+            part.shots.add(playSelfPlayGame(side.params, side.difficulty, settings.seed, index, &part.moves));
+            if (playAiMatch(side, reference, settings.seed, index).winner == 0) part.wins++;
+        }
+    });
+
+    std::vector<double> moves;
+    for (const auto& part : parts) {
+        point.shots.merge(part.shots);
+        point.wins += part.wins;
+        moves.insert(moves.end(), part.moves.begin(), part.moves.end());
+    }
+    point.matches = settings.games;
+
+    if (!moves.empty()) {
+        double total = 0.0;
+        for (double m : moves) total += m;
+        point.meanMoveMs = 1000.0 * total / moves.size();
+        size_t p99 = std::min(moves.size() - 1, static_cast<size_t>(0.99 * moves.size()));
+        std::nth_element(moves.begin(), moves.begin() + p99, moves.end());
+        point.p99MoveMs = 1000.0 * moves[p99];
+    }
+    return point;
+}
+
+inline bool writeSweepCsv(const std::string& fileName, const std::vector<SweepPoint>& points) {
+    std::ofstream out(fileName);
+    if (!out) return false;
+    out << "strategy,budget_ms,mean_move_ms,p99_move_ms,mean_shots,p50_shots,p90_shots,win_rate,ci_low,ci_high\n";
+    out << std::fixed << std::setprecision(4);
+    for (const auto& p : points) {
+        double low, high;
+        wilsonInterval(p.wins, p.matches, low, high);
+        out << p.strategy << "," << p.budgetMs << "," << p.meanMoveMs << "," << p.p99MoveMs << ","
+            << p.shots.mean() << "," << p.shots.percentile(0.5) << "," << p.shots.percentile(0.9) << ","
+            << static_cast<double>(p.wins) / p.matches << "," << low << "," << high << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+inline bool writeSweepJson(const std::string& fileName, const std::vector<SweepPoint>& points,
+    const SweepSettings& settings) {
+    std::ofstream out(fileName);
+    if (!out) return false;
+    out << std::fixed << std::setprecision(4);
+    out << "{\n  \"seed\": " << settings.seed << ",\n  \"games\": " << settings.games
+        << ",\n  \"reference\": \"" << settings.reference << "\",\n  \"points\": [\n";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const SweepPoint& p = points[i];
+        double low, high;
+        wilsonInterval(p.wins, p.matches, low, high);
+        out << "    { \"strategy\": \"" << p.strategy << "\", \"budget_ms\": " << p.budgetMs
+            << ", \"mean_move_ms\": " << p.meanMoveMs << ", \"p99_move_ms\": " << p.p99MoveMs
+            << ", \"mean_shots\": " << p.shots.mean() << ", \"p90_shots\": " << p.shots.percentile(0.9)
+            << ", \"win_rate\": " << static_cast<double>(p.wins) / p.matches
+            << ", \"ci95\": [" << low << ", " << high << "] }" << (i + 1 < points.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+inline int runSweep(const SweepSettings& settings) {
+    std::vector<Strategy> strategies = registeredStrategies("");
+    auto reference = std::find_if(strategies.begin(), strategies.end(),
+        [&settings](const Strategy& s) { return s.name == settings.reference; });
+    if (reference == strategies.end()) {
+        std::cerr << "Unknown reference strategy: " << settings.reference << std::endl;
+        return 1;
+    }
+
+    int threads = settings.threads > 0 ? settings.threads : defaultThreadCount();
+    WorkStealingPool pool(threads);
+    std::cout << settings.games << " games per point, " << threads << " threads, seed " << settings.seed
+        << ", win rate against " << settings.reference << "\n\n";
+    std::cout << std::left << std::setw(10) << "strategy" << std::right << std::setw(11) << "budget ms"
+        << std::setw(11) << "move ms" << std::setw(11) << "p99 ms" << std::setw(8) << "shots"
+        << std::setw(8) << "win %" << "  curve\n";
+
+    std::vector<SweepPoint> points;
+    std::cout << std::fixed;
+    for (const auto& strategy : strategies) {
+        if (!isTimeBudgeted(strategy)) continue;
+        for (double budget : settings.budgetsMs) {
+            SweepPoint p = measureBudget(strategy, reference->side, budget, settings, pool);
+            points.push_back(p);
+
+            double rate = static_cast<double>(p.wins) / p.matches;
+            std::cout << std::left << std::setw(10) << p.strategy << std::right
+                << std::setw(11) << std::setprecision(3) << p.budgetMs
+                << std::setw(11) << p.meanMoveMs << std::setw(11) << p.p99MoveMs
+                << std::setw(8) << std::setprecision(2) << p.shots.mean()
+                << std::setw(8) << std::setprecision(1) << 100.0 * rate
+                << "  " << std::string(static_cast<size_t>(rate * 40 + 0.5), '#') << std::endl;
+        }
+    }
+
+    if (!settings.csvFile.empty() && !writeSweepCsv(settings.csvFile, points)) {
+        std::cerr << "Failed to save sweep CSV" << std::endl;
+        return 1;
+    }
+    if (!settings.jsonFile.empty() && !writeSweepJson(settings.jsonFile, points, settings)) {
+        std::cerr << "Failed to save sweep JSON" << std::endl;
+        return 1;
+    }
+    return 0;
+}
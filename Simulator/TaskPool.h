@@ -0,0 +1,137 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <memory>
+
+// Пул потоков с перехватом задач. Задачи - номера 0..count-1, изначально
+// раздаются по очередям потоков подряд идущими блоками. Поток берет задачи
+// с конца своей очереди, а опустев - забирает с начала чужих.
+// Потоки создаются один раз в конструкторе и между вызовами run спят на
+// условной переменной; поток, вызвавший run, работает как поток 0.
+class WorkStealingPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+
+    int threadCount;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;           // новый вызов run или остановка
+    std::condition_variable finished;       // последний поток закончил свою часть
+    const std::function<void(int, int)>* body;
+    long long generation;                   // номер вызова run
+    int working;                            // потоки пула, еще не закончившие текущий run
+    bool stopping;
+
+    static bool popOwn(Queue& queue, int& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    static bool steal(Queue& queue, int& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    // Новые задачи во время run не появляются, поэтому пустые очереди означают конец
+    void work(int self) {
+        int task;
+        while (true) {
+            if (popOwn(*queues[self], task)) {
+                (*body)(self, task);
+                continue;
+            }
+
+            bool stolen = false;
+            for (int i = 1; i < threadCount && !stolen; ++i) {
+                stolen = steal(*queues[(self + i) % threadCount], task);
+            }
+            if (!stolen) return;
+            (*body)(self, task);
+        }
+    }
+
+    void workerLoop(int self) {
+        long long seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            work(self);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--working == 0) finished.notify_one();
+        }
+    }
+
+public:
+    explicit WorkStealingPool(int threads) : threadCount(threads > 0 ? threads : 1),
+        body(nullptr), generation(0), working(0), stopping(false) {
+        for (int t = 0; t < threadCount; ++t) {
+            queues.emplace_back(new Queue());
+        }
+        for (int t = 1; t < threadCount; ++t) {
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, t);
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    int threads() const {
+        return threadCount;
+    }
+
+    // body(worker, task) для всех задач; возвращает после выполнения всех
+    void run(int count, const std::function<void(int, int)>& task) {
+        // Прошлый run опустошил все очереди, потоки пула в это время спят
+        for (int t = 0; t < threadCount; ++t) {
+            int begin = static_cast<int>(static_cast<long long>(count) * t / threadCount);
+            int end = static_cast<int>(static_cast<long long>(count) * (t + 1) / threadCount);
+            // Свои задачи берутся с конца - кладем в обратном порядке, чтобы идти по возрастанию
+            std::lock_guard<std::mutex> lock(queues[t]->mutex);
+            for (int i = end - 1; i >= begin; --i) {
+                queues[t]->tasks.push_back(i);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            body = &task;
+            working = threadCount - 1;
+            ++generation;
+        }
+        wake.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() { return working == 0; });
+        body = nullptr;
+    }
+};
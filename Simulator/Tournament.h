@@ -0,0 +1,340 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <chrono>
+#include <functional>
+
+#include "SelfPlay.h"
+#include "Simulate.h"
+#include "TaskPool.h"
+#include "Checkpoint.h"
+
+// Стратегия турнира: уровень сложности и параметры ИИ
+struct Strategy {
+    std::string name;
+    MatchSide side;
+};
+
+// Все стратегии, которые играют в турнире. Новые стратегии добавляются сюда.
+inline std::vector<Strategy> registeredStrategies(const std::string& tunedConfig) {
+    std::vector<Strategy> strategies = {
+        { "easy", { AiParams(), Difficulty::Easy } },
+        { "medium", { AiParams(), Difficulty::Medium } },
+        { "hard", { AiParams(), Difficulty::Hard } }
+    };
+
+    // Выборка расстановок с фиксированным числом расстановок на ход (детерминированно)
+    AiParams sampled;
+    sampled.sampleBudget = 200.0f;
+    strategies.push_back({ "hard-mc", { sampled, Difficulty::Hard } });
+
+    if (!tunedConfig.empty()) {
+        AiParams tuned;
+        if (tuned.loadFromFile(tunedConfig)) {
+            strategies.push_back({ "hard-tuned", { tuned, Difficulty::Hard } });
+        }
+        else {
+            std::cerr << "Failed to load AI config" << std::endl;
+        }
+    }
+    return strategies;
+}
+
+struct TournamentSettings {
+    long long maxGames = 10000;     // на пару
+    int block = 200;                // партий между проверками остановки
+    bool earlyStop = true;
+    int threads = 0;
+    uint64_t seed = 1;
+    std::string tunedConfig;
+    std::string csvFile;
+    std::string jsonFile;
+    std::string checkpointFile;     // пусто - без контрольных точек
+    bool resume = false;
+};
+
+struct PairingResult {
+    int first = 0;
+    int second = 0;
+    long long winsFirst = 0;
+    ShotStats shotsFirst;           // выстрелы первой стратегии в выигранных ею партиях
+    ShotStats shotsSecond;
+    std::string decision;
+
+    long long games() const {
+        return shotsFirst.games + shotsSecond.games;
+    }
+};
+
+// Доверительный интервал Уилсона для доли побед (z = 1.96 - 95%)
+inline void wilsonInterval(long long wins, long long games, double& low, double& high, double z = 1.959964) {
+    if (games == 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+    double p = static_cast<double>(wins) / games;
+    double denominator = 1.0 + z * z / games;
+    double center = (p + z * z / (2.0 * games)) / denominator;
+    double margin = z * std::sqrt(p * (1.0 - p) / games + z * z / (4.0 * games * games)) / denominator;
+    low = center - margin;
+    high = center + margin;
+}
+
+// Правило остановки пары. Проверка повторяется после каждого блока, поэтому
+// для "сильнее" берем строгий интервал 99.9%, чтобы не ловить случайные выбросы.
+// Возвращает +1 - первая сильнее, -1 - вторая сильнее, 2 - равны в пределах 3%, 0 - играть дальше.
+inline int stopDecision(long long wins, long long games) {
+    const double strictZ = 3.290527;
+    const double equalMargin = 0.03;
+    double low, high;
+    wilsonInterval(wins, games, low, high, strictZ);
+    if (low > 0.5) return 1;
+    if (high < 0.5) return -1;
+
+    wilsonInterval(wins, games, low, high);
+    if (low > 0.5 - equalMargin && high < 0.5 + equalMargin) return 2;
+    return 0;
+}
+
+// Партии пары играются блоками; внутри блока - параллельно. Решение об остановке
+// принимается только на границе блока, поэтому результат не зависит от числа потоков.
+// result может уже содержать сыгранные блоки (продолжение с контрольной точки);
+// onBlock вызывается после каждого блока, если пара еще не закончена.
+inline void playPairing(const std::vector<Strategy>& strategies, const TournamentSettings& settings,
+    WorkStealingPool& pool, PairingResult& result, const std::function<void(const PairingResult&)>& onBlock) {
+    const int first = result.first;
+    const int second = result.second;
+
+    const int chunk = 25;
+    for (long long begin = result.games(); begin < settings.maxGames; begin += settings.block) {
+        long long end = std::min(settings.maxGames, begin + settings.block);
+        int tasks = static_cast<int>((end - begin + chunk - 1) / chunk);
+        std::vector<PairingResult> partial(tasks);
+
+        pool.run(tasks, [&](int, int task) {
+            PairingResult& part = partial[task];
+            long long from = begin + static_cast<long long>(task) * chunk;
+            long long to = std::min(end, from + chunk);
+            for (long long g = from; g < to; ++g) {
+                MatchResult match = playAiMatch(strategies[first].side, strategies[second].side,
+                    settings.seed, static_cast<uint32_t>(g));
+                if (match.winner == 0) {
+                    part.winsFirst++;
+                    part.shotsFirst.add(match.shots[0]);
+                }
+                else {
+                    part.shotsSecond.add(match.shots[1]);
+                }
+            }
+        });
+
+        for (const auto& part : partial) {
+            result.winsFirst += part.winsFirst;
+            result.shotsFirst.merge(part.shotsFirst);
+            result.shotsSecond.merge(part.shotsSecond);
+        }
+
+        if (settings.earlyStop) {
+            int decision = stopDecision(result.winsFirst, result.games());
+            if (decision == 1) result.decision = strategies[first].name + " stronger";
+            if (decision == -1) result.decision = strategies[second].name + " stronger";
+            if (decision == 2) result.decision = "equal within 3%";
+            if (decision != 0) break;
+        }
+        if (end < settings.maxGames) onBlock(result);
+    }
+}
+
+inline void writePairing(std::ostream& out, const PairingResult& r) {
+    out << r.first << " " << r.second << " " << r.winsFirst << "\n";
+    writeShotStats(out, r.shotsFirst);
+    writeShotStats(out, r.shotsSecond);
+    out << r.decision << "\n";
+}
+
+inline bool readPairing(std::istream& in, PairingResult& r) {
+    in >> r.first >> r.second >> r.winsFirst;
+    if (!readShotStats(in, r.shotsFirst) || !readShotStats(in, r.shotsSecond)) return false;
+    in >> std::ws;
+    return static_cast<bool>(std::getline(in, r.decision));
+}
+
+// Точка: законченные пары и, если есть, недоигранная пара
+inline bool saveTournamentCheckpoint(const std::string& fileName, const TournamentSettings& settings,
+    const std::vector<Strategy>& strategies, const std::vector<PairingResult>& results, const PairingResult* current) {
+    return writeFileAtomically(fileName, [&](std::ostream& out) {
+        out << "SeaBattleTournament 1\n" << settings.seed << " " << settings.maxGames << " " << settings.block << " "
+            << settings.earlyStop << " " << strategies.size() << "\n";
+        for (const auto& s : strategies) out << s.name << "\n";
+        out << results.size() << " " << (current ? 1 : 0) << "\n";
+        for (const auto& r : results) writePairing(out, r);
+        if (current) writePairing(out, *current);
+    });
+}
+
+// Точка подходит, только если настройки и список стратегий те же
+inline bool loadTournamentCheckpoint(const std::string& fileName, const TournamentSettings& settings,
+    const std::vector<Strategy>& strategies, std::vector<PairingResult>& results, PairingResult& current, bool& hasCurrent) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    std::string magic;
+    int version = 0;
+    uint64_t seed = 0;
+    long long maxGames = 0;
+    int block = 0;
+    bool earlyStop = false;
+    size_t count = 0;
+    in >> magic >> version >> seed >> maxGames >> block >> earlyStop >> count;
+    if (!in || magic != "SeaBattleTournament" || version != 1) return false;
+    if (seed != settings.seed || maxGames != settings.maxGames || block != settings.block ||
+        earlyStop != settings.earlyStop || count != strategies.size()) return false;
+    for (const auto& s : strategies) {
+        std::string name;
+        in >> name;
+        if (name != s.name) return false;
+    }
+
+    size_t finished = 0;
+    int partial = 0;
+    in >> finished >> partial;
+    std::vector<PairingResult> loaded(finished);
+    for (auto& r : loaded) {
+        if (!readPairing(in, r)) return false;
+    }
+    PairingResult loadedCurrent;
+    if (partial && !readPairing(in, loadedCurrent)) return false;
+    if (!in) return false;
+
+    results = loaded;
+    current = loadedCurrent;
+    hasCurrent = partial != 0;
+    return true;
+}
+
+inline bool writeTournamentCsv(const std::string& fileName, const std::vector<Strategy>& strategies,
+    const std::vector<PairingResult>& results) {
+    std::ofstream out(fileName);
+    if (!out) return false;
+    out << "first,second,games,first_wins,win_rate,ci_low,ci_high,first_mean_shots,first_p50,first_p90,"
+        << "second_mean_shots,second_p50,second_p90,decision\n";
+    out << std::fixed << std::setprecision(4);
+    for (const auto& r : results) {
+        double low, high;
+        wilsonInterval(r.winsFirst, r.games(), low, high);
+        out << strategies[r.first].name << "," << strategies[r.second].name << "," << r.games() << ","
+            << r.winsFirst << "," << static_cast<double>(r.winsFirst) / r.games() << "," << low << "," << high << ","
+            << r.shotsFirst.mean() << "," << r.shotsFirst.percentile(0.5) << "," << r.shotsFirst.percentile(0.9) << ","
+            << r.shotsSecond.mean() << "," << r.shotsSecond.percentile(0.5) << "," << r.shotsSecond.percentile(0.9) << ","
+            << r.decision << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+inline bool writeTournamentJson(const std::string& fileName, const std::vector<Strategy>& strategies,
+    const std::vector<PairingResult>& results, uint64_t seed) {
+    std::ofstream out(fileName);
+    if (!out) return false;
+
+    auto writeShots = [&out](const ShotStats& stats) {
+        out << "{ \"games\": " << stats.games << ", \"mean\": " << stats.mean()
+            << ", \"p50\": " << stats.percentile(0.5) << ", \"p90\": " << stats.percentile(0.9)
+            << ", \"p99\": " << stats.percentile(0.99) << " }";
+    };
+
+    out << std::fixed << std::setprecision(4);
+    out << "{\n  \"seed\": " << seed << ",\n  \"pairings\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const PairingResult& r = results[i];
+        double low, high;
+        wilsonInterval(r.winsFirst, r.games(), low, high);
+        out << "    { \"first\": \"" << strategies[r.first].name << "\", \"second\": \"" << strategies[r.second].name
+            << "\", \"games\": " << r.games() << ", \"first_wins\": " << r.winsFirst
+            << ", \"win_rate\": " << static_cast<double>(r.winsFirst) / r.games()
+            << ", \"ci95\": [" << low << ", " << high << "], \"first_shots\": ";
+        writeShots(r.shotsFirst);
+        out << ", \"second_shots\": ";
+        writeShots(r.shotsSecond);
+        out << ", \"decision\": \"" << r.decision << "\" }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+inline int runTournament(const TournamentSettings& settings) {
+    std::vector<Strategy> strategies = registeredStrategies(settings.tunedConfig);
+    int threads = settings.threads > 0 ? settings.threads : defaultThreadCount();
+    WorkStealingPool pool(threads);
+
+    std::cout << strategies.size() << " strategies, up to " << settings.maxGames << " games per pairing, "
+        << threads << " threads, seed " << settings.seed << "\n\n";
+    std::cout << std::left << std::setw(26) << "pairing" << std::right << std::setw(8) << "games"
+        << std::setw(9) << "win %" << std::setw(18) << "95% CI" << std::setw(9) << "shots 1" << std::setw(9) << "shots 2"
+        << "  decision\n";
+
+    auto printPairing = [&strategies](const PairingResult& r) {
+        double low, high;
+        wilsonInterval(r.winsFirst, r.games(), low, high);
+        std::cout << std::left << std::setw(26) << strategies[r.first].name + " vs " + strategies[r.second].name
+            << std::right << std::setw(8) << r.games()
+            << std::setw(9) << std::setprecision(1) << 100.0 * r.winsFirst / r.games()
+            << std::setw(8) << 100.0 * low << " - " << std::setw(5) << 100.0 * high
+            << std::setw(9) << std::setprecision(2) << r.shotsFirst.mean()
+            << std::setw(9) << r.shotsSecond.mean()
+            << "  " << r.decision << std::endl;
+    };
+
+    std::vector<PairingResult> results;
+    PairingResult current;
+    bool hasCurrent = false;
+    bool checkpoints = !settings.checkpointFile.empty();
+    if (checkpoints && settings.resume &&
+        !loadTournamentCheckpoint(settings.checkpointFile, settings, strategies, results, current, hasCurrent)) {
+        std::cerr << "Failed to load tournament checkpoint" << std::endl;
+        return 1;
+    }
+    auto save = [&](const PairingResult* partial) {
+        if (checkpoints && !saveTournamentCheckpoint(settings.checkpointFile, settings, strategies, results, partial)) {
+            std::cerr << "Failed to save tournament checkpoint" << std::endl;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::cout << std::fixed;
+    for (const auto& r : results) printPairing(r);
+    size_t pairing = 0;
+    for (size_t a = 0; a < strategies.size(); ++a) {
+        for (size_t b = a + 1; b < strategies.size(); ++b, ++pairing) {
+            if (pairing < results.size()) continue;
+
+            PairingResult r;
+            r.first = static_cast<int>(a);
+            r.second = static_cast<int>(b);
+            r.decision = "max games";
+            if (hasCurrent) {
+                r = current;
+                hasCurrent = false;
+            }
+            playPairing(strategies, settings, pool, r, [&save](const PairingResult& partial) { save(&partial); });
+            results.push_back(r);
+            save(nullptr);
+            printPairing(r);
+        }
+    }
+    std::cout << "\nFinished in " << std::setprecision(1) << secondsSince(start) << " s" << std::endl;
+
+    if (!settings.csvFile.empty() && !writeTournamentCsv(settings.csvFile, strategies, results)) {
+        std::cerr << "Failed to save tournament CSV" << std::endl;
+        return 1;
+    }
+    if (!settings.jsonFile.empty() && !writeTournamentJson(settings.jsonFile, strategies, results, settings.seed)) {
+        std::cerr << "Failed to save tournament JSON" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,210 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+
+#include "SelfPlay.h"
+#include "Checkpoint.h"
+#include "Simulate.h"
+#include "TaskPool.h"
+
+// Настраиваемый параметр и его допустимый диапазон
+struct TunedParam {
+    const char* name;
+    float AiParams::* field;
+    float minValue;
+    float maxValue;
+};
+
+inline const std::vector<TunedParam>& tunedParams() {
+    static const std::vector<TunedParam> params = {
+        { "parityBonus", &AiParams::parityBonus, 0.5f, 3.0f },
+        { "edgeWeight", &AiParams::edgeWeight, 0.5f, 2.0f },
+        { "targetHeatWeight", &AiParams::targetHeatWeight, 0.0f, 5.0f }
+    };
+    return params;
+}
+
+struct TunerSettings {
+    int iterations = 200;
+    int gamesPerEval = 2000;
+    int threads = 0;                // 0 - по числу ядер
+    uint64_t seed = 1;
+    Difficulty difficulty = Difficulty::Hard;
+    std::string checkpointFile = "tune_checkpoint.txt";
+    std::string outputFile = "ai_config.txt";
+    bool resume = false;
+
+    // Коэффициенты SPSA (Spall): a_k = a / (k + 1 + A)^0.602, c_k = c / (k + 1)^0.101
+    double a = 0.02;
+    double A = 20.0;
+    double c = 0.1;
+};
+
+// Состояние оптимизации, которое пишется в контрольную точку
+struct TunerState {
+    int iteration = 0;
+    uint64_t seed = 0;
+    std::vector<double> theta;      // нормированные координаты 0..1
+    double lastLoss = 0.0;
+};
+
+inline double clamp01(double v) {
+    return std::min(1.0, std::max(0.0, v));
+}
+
+inline AiParams paramsFromTheta(const AiParams& base, const std::vector<double>& theta) {
+    AiParams p = base;
+    const auto& tuned = tunedParams();
+    for (size_t i = 0; i < tuned.size(); ++i) {
+        p.*tuned[i].field = static_cast<float>(
+            tuned[i].minValue + clamp01(theta[i]) * (tuned[i].maxValue - tuned[i].minValue));
+    }
+    return p;
+}
+
+inline std::vector<double> thetaFromParams(const AiParams& p) {
+    std::vector<double> theta;
+    for (const auto& t : tunedParams()) {
+        theta.push_back(clamp01((p.*t.field - t.minValue) / (t.maxValue - t.minValue)));
+    }
+    return theta;
+}
+
+// Сумма выстрелов по партиям 0..games-1 серии seed. Партии идут задачами
+// пула по chunk штук; сумма целочисленная, поэтому результат не зависит
+// от числа потоков и порядка выполнения.
+inline long long evaluateParams(const AiParams& params, Difficulty difficulty, uint64_t seed, int games,
+    WorkStealingPool& pool) {
+    const int chunk = 16;
+    int tasks = (games + chunk - 1) / chunk;
+    std::vector<long long> sums(tasks, 0);
+
+    pool.run(tasks, [&](int, int task) {
+        int end = std::min(games, (task + 1) * chunk);
+        for (int g = task * chunk; g < end; ++g) {
+            sums[task] += playSelfPlayGame(params, difficulty, seed, static_cast<uint32_t>(g));
+        }
+    });
+
+    long long total = 0;
+    for (long long s : sums) total += s;
+    return total;
+}
+
+// В заголовке - настройки, от которых зависит ход оптимизации
+inline bool saveTunerCheckpoint(const std::string& fileName, const TunerSettings& settings, const TunerState& state) {
+    return writeFileAtomically(fileName, [&](std::ostream& out) {
+        out << "SeaBattleTune 2\n" << static_cast<int>(settings.difficulty) << " " << settings.gamesPerEval << " "
+            << settings.a << " " << settings.A << " " << settings.c << "\n";
+        out << state.iteration << " " << state.seed << " " << state.lastLoss << "\n";
+        for (double v : state.theta) out << v << " ";
+        out << "\n";
+    });
+}
+
+// Точка подходит, только если уровень, число партий и коэффициенты SPSA те же
+inline bool loadTunerCheckpoint(const std::string& fileName, const TunerSettings& settings, TunerState& state) {
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    std::string magic;
+    int version = 0;
+    int difficulty = 0;
+    int gamesPerEval = 0;
+    double a = 0.0, A = 0.0, c = 0.0;
+    in >> magic >> version >> difficulty >> gamesPerEval >> a >> A >> c;
+    if (!in || magic != "SeaBattleTune" || version != 2) return false;
+    if (difficulty != static_cast<int>(settings.difficulty) || gamesPerEval != settings.gamesPerEval ||
+        a != settings.a || A != settings.A || c != settings.c) return false;
+
+    TunerState loaded;
+    in >> loaded.iteration >> loaded.seed >> loaded.lastLoss;
+    loaded.theta.resize(tunedParams().size());
+    for (double& v : loaded.theta) in >> v;
+
+    if (!in) return false;
+    state = loaded;
+    return true;
+}
+
+// SPSA: на каждой итерации два прогона с возмущением +-c_k * delta по всем
+// параметрам сразу. Оба прогона играют одни и те же партии (общие случайные
+// числа), поэтому разница потерь почти не содержит шума расстановок.
+inline int runTuner(const TunerSettings& settings) {
+    int threads = settings.threads > 0 ? settings.threads : defaultThreadCount();
+    WorkStealingPool pool(threads);
+
+    AiParams base;
+    std::ifstream config(settings.outputFile);
+    if (config && !base.loadFromFile(settings.outputFile)) {
+        std::cerr << "Failed to load AI config" << std::endl;
+    }
+
+    TunerState state;
+    state.seed = settings.seed;
+    state.theta = thetaFromParams(base);
+    if (settings.resume) {
+        if (!loadTunerCheckpoint(settings.checkpointFile, settings, state)) {
+            std::cerr << "Failed to load tuner checkpoint" << std::endl;
+            return 1;
+        }
+        std::cout << "Resumed at iteration " << state.iteration << std::endl;
+    }
+
+    const size_t dims = state.theta.size();
+    for (int k = state.iteration; k < settings.iterations; ++k) {
+        double ak = settings.a / std::pow(k + 1 + settings.A, 0.602);
+        double ck = settings.c / std::pow(k + 1, 0.101);
+
+        // Возмущение и серия партий зависят только от (seed, k) - возобновленный
+        // прогон повторяет те же итерации
+        GameRng deltaGen = selfPlayStream(state.seed, static_cast<uint32_t>(k), STREAM_TUNER);
+        std::vector<double> delta(dims);
+        for (double& d : delta) d = randomInt(deltaGen, 0, 1) ? 1.0 : -1.0;
+        uint64_t gamesSeed = deltaGen();
+
+        std::vector<double> plus(dims), minus(dims);
+        for (size_t i = 0; i < dims; ++i) {
+            plus[i] = clamp01(state.theta[i] + ck * delta[i]);
+            minus[i] = clamp01(state.theta[i] - ck * delta[i]);
+        }
+
+        double lossPlus = static_cast<double>(evaluateParams(paramsFromTheta(base, plus), settings.difficulty,
+            gamesSeed, settings.gamesPerEval, pool)) / settings.gamesPerEval;
+        double lossMinus = static_cast<double>(evaluateParams(paramsFromTheta(base, minus), settings.difficulty,
+            gamesSeed, settings.gamesPerEval, pool)) / settings.gamesPerEval;
+
+        for (size_t i = 0; i < dims; ++i) {
+            double step = plus[i] - minus[i];
+            if (step == 0.0) continue;
+            state.theta[i] = clamp01(state.theta[i] - ak * (lossPlus - lossMinus) / step);
+        }
+        state.lastLoss = (lossPlus + lossMinus) / 2;
+
+        std::cout << "iter " << k + 1 << "/" << settings.iterations
+            << " shots+ " << lossPlus << " shots- " << lossMinus;
+        AiParams current = paramsFromTheta(base, state.theta);
+        for (const auto& t : tunedParams()) {
+            std::cout << " " << t.name << "=" << current.*t.field;
+        }
+        std::cout << std::endl;
+
+        state.iteration = k + 1;
+        if (!saveTunerCheckpoint(settings.checkpointFile, settings, state)) {
+            std::cerr << "Failed to save tuner checkpoint" << std::endl;
+        }
+    }
+
+    if (!paramsFromTheta(base, state.theta).saveToFile(settings.outputFile)) {
+        std::cerr << "Failed to save AI config" << std::endl;
+        return 1;
+    }
+    std::cout << "Saved " << settings.outputFile << std::endl;
+    return 0;
+}